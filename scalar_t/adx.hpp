@@ -0,0 +1,170 @@
+/* Copyright (C) 2020 D8DATAWORKS - All Rights Reserved */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "intrinsic.hpp"
+
+/*
+	BMI2 / ADX kernels for 64 bit limbs and the runtime switch that selects them.
+
+	cpuid is read once during static initialization into intrinsic::bmi2_adx. The basecase multiplies, FMADD, FM2IAD and
+	the Montgomery kernels branch on it from adx::threshold limbs and keep their portable code for every other CPU, SCALAR_T_NO_ADX compiles the switch out.
+
+	Every kernel is built from rows r += a * w: mulx forms each product without touching the flags, adcx adds the low half
+	to the previous high half on CF and adox adds that sum into r on OF, so the two carry chains never wait on each other.
+*/
+
+#if !defined(SCALAR_T_NO_ADX) && (defined(SCALAR_T_X86INTRIN) || defined(SCALAR_T_MSVC_X64))
+	#define SCALAR_T_ADX
+	#if defined(SCALAR_T_X86INTRIN)
+		#include <cpuid.h>
+	#endif
+#endif
+
+namespace scalar_t
+{
+	namespace intrinsic
+	{
+#if defined(SCALAR_T_ADX)
+		//cpuid leaf 7, ebx bit 8 is BMI2 and bit 19 is ADX
+		//
+		inline bool detect_bmi2_adx()
+		{
+			unsigned int ebx = 0;
+
+	#if defined(SCALAR_T_MSVC_X64)
+			int r[4];
+			__cpuid(r, 0);
+
+			if (r[0] < 7)
+				return false;
+
+			__cpuidex(r, 7, 0);
+			ebx = (unsigned int)r[1];
+	#else
+			unsigned int eax, ecx, edx;
+
+			if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+				return false;
+	#endif
+
+			return ((ebx >> 8) & 1) && ((ebx >> 19) & 1);
+		}
+
+		inline const bool bmi2_adx = detect_bmi2_adx();
+#else
+		inline constexpr bool bmi2_adx = false;
+#endif
+	}
+
+#if defined(SCALAR_T_ADX)
+	namespace helper
+	{
+		namespace adx
+		{
+#ifndef SCALAR_T_ADX_THRESHOLD
+#define SCALAR_T_ADX_THRESHOLD 8
+#endif
+
+			//Limb count from which the kernels below replace the portable ones, shorter rows lose more to the call than they gain.
+			//
+			constexpr size_t threshold = SCALAR_T_ADX_THRESHOLD;
+
+			//r += a * w over n > 0 limbs, returns the carry out of r[0]
+			//
+			inline uint64_t addmul_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t w)
+			{
+	#if defined(SCALAR_T_MSVC_X64)
+				unsigned char cf = 0, of = 0;
+				unsigned __int64 c = 0, h, l;
+
+				for (size_t i = n - 1; i != -1; i--)
+				{
+					l = _mulx_u64(a[i], w, &h);
+
+					cf = _addcarryx_u64(cf, l, c, &l);
+					of = _addcarryx_u64(of, r[i], l, (unsigned __int64*)&r[i]);
+
+					c = h;
+				}
+
+				_addcarryx_u64(cf, c, 0, &c);
+				_addcarryx_u64(of, c, 0, &c);
+
+				return c;
+	#else
+				//Two limbs per pass, an odd n enters at the second half. jrcxz and lea leave CF and OF alone, so the loop runs on rcx without a compare.
+				//
+				uint64_t c, z, h, l;
+
+				__asm__ volatile
+				(
+					"test $1, %[n]\n\t"
+					"jz 1f\n\t"
+					"lea 1(%[n]), %[n]\n\t"
+					"xor %[z], %[z]\n\t"
+					"xor %[h], %[h]\n\t"
+					"jmp 3f\n"
+				"1:\n\t"
+					"xor %[z], %[z]\n\t"
+					"xor %[c], %[c]\n"
+				"2:\n\t"
+					"mulx -8(%[a],%[n],8), %[l], %[h]\n\t"
+					"adcx %[c], %[l]\n\t"
+					"adox -8(%[r],%[n],8), %[l]\n\t"
+					"mov %[l], -8(%[r],%[n],8)\n"
+				"3:\n\t"
+					"mulx -16(%[a],%[n],8), %[l], %[c]\n\t"
+					"adcx %[h], %[l]\n\t"
+					"adox -16(%[r],%[n],8), %[l]\n\t"
+					"mov %[l], -16(%[r],%[n],8)\n\t"
+					"lea -2(%[n]), %[n]\n\t"
+					"jrcxz 4f\n\t"
+					"jmp 2b\n"
+				"4:\n\t"
+					"adcx %[z], %[c]\n\t"
+					"adox %[z], %[c]\n\t"
+					: [c] "=&r"(c), [z] "=&r"(z), [h] "=&r"(h), [l] "=&r"(l), [n] "+c"(n)
+					: [a] "r"(a), [r] "r"(r), "d"(w)
+					: "cc", "memory"
+				);
+
+				return c;
+	#endif
+			}
+
+			//r = a * b over 2n limbs, one row per limb of b from the least significant
+			//
+			inline void mul_basecase(const uint64_t* a, const uint64_t* b, size_t n, uint64_t* r)
+			{
+				for (size_t i = 0; i < 2 * n; i++)
+					r[i] = 0;
+
+				for (size_t i = 0; i < n; i++)
+					r[n - 1 - i] = addmul_1(r + n - i, a, n, b[n - 1 - i]);
+			}
+
+			//r += a * b mod B^n, row i only needs the low n - i limbs of a
+			//
+			inline void addmullo(const uint64_t* a, const uint64_t* b, size_t n, uint64_t* r)
+			{
+				for (size_t i = 0; i < n; i++)
+					addmul_1(r, a + i, n - i, b[n - 1 - i]);
+			}
+
+			//r = a * b mod B^n
+			//
+			inline void mullo_basecase(const uint64_t* a, const uint64_t* b, size_t n, uint64_t* r)
+			{
+				for (size_t i = 0; i < n; i++)
+					r[i] = 0;
+
+				addmullo(a, b, n, r);
+			}
+		}
+	}
+#endif
+}
@@ -0,0 +1,135 @@
+/* Copyright (C) 2020 D8DATAWORKS - All Rights Reserved */
+
+#pragma once
+
+#include <array>
+
+#include "int.hpp"
+
+namespace scalar_t
+{
+	/*
+		Barrett reduction by a fixed modulus m != 0, values stay in ordinary form.
+
+		With k the significant limb count of m and mu = floor( B^2k / m ), a 2k limb x < m * B^k reduces as
+
+		q = floor( floor( x / B^(k-1) ) * mu / B^(k+1) )
+		r = ( x - q * m ) mod B^(k+1)
+
+		q is taken from the exact high half of the k + 1 by k + 1 limb product, so q <= floor( x / m ) <= q + 2
+		and r < 3m: two conditional subtractions of m finish it. q * m is a low short product of k + 1 limbs.
+		Wider inputs are folded k limbs at a time from the top, a full size modulus takes a single step.
+		m = B^(k-1) is the one modulus where mu needs k + 2 limbs, it reduces by dropping limbs instead.
+	*/
+
+	template < typename U > class BarrettContext
+	{
+		using T = typename U::value_type;
+		static constexpr size_t S = helper::limbs<U>;
+
+		using W = uintv_t<T, 2 * S>;
+
+		U m;
+		size_t k;
+
+		//m = B^(k-1)
+		//
+		bool power;
+
+		//mu and m in their first k + 1 limbs, most significant first
+		//
+		std::array<T, S + 1> mu;
+		std::array<T, S + 1> mk;
+
+		//y is 2k limbs below m * B^k, leaves y mod m in y[k .. 2k)
+		//
+		void Step(T* y) const
+		{
+			std::array<T, 2 * S + 2> qw;
+			std::array<T, S + 1> r;
+
+			helper::mul_basecase<T>(y, mu.data(), k + 1, qw.data());
+			helper::mullo_basecase<T>(qw.data(), mk.data(), k + 1, r.data());
+
+			T* r1 = y + k - 1;
+
+			helper::sub_n<T>(r1, r1, r.data(), k + 1);
+
+			for (size_t i = 0; i < 2; i++)
+				if (!helper::less_n<T>(r1, mk.data(), k + 1))
+					helper::sub_n<T>(r1, r1, mk.data(), k + 1);
+		}
+
+	public:
+
+		BarrettContext(const U& modulus) : m(modulus), power(false), mu{}, mk{}
+		{
+			size_t top = 0;
+
+			while (top < S - 1 && !m[top])
+				top++;
+
+			k = S - top;
+
+			std::copy(m.begin() + top, m.end(), mk.begin() + 1);
+
+			uintv_t<T, 2 * S + 1> b2k, wm;
+
+			b2k[2 * S - 2 * k] = 1;
+			std::copy(m.begin(), m.end(), wm.begin() + S + 1);
+
+			auto q = helper::finite_vector_div(b2k, wm).first;
+
+			power = q[2 * S - k - 1] != 0;
+
+			std::copy(q.begin() + 2 * S - k, q.end(), mu.begin());
+		}
+
+		const U& Modulus() const { return m; }
+
+		//x mod m
+		//
+		U Reduce(const W& x) const
+		{
+			if (power)
+			{
+				U result;
+				std::copy(x.end() - (k - 1), x.end(), result.end() - (k - 1));
+
+				return result;
+			}
+
+			std::array<T, 3 * S> y{};
+
+			size_t steps = (2 * S + k - 1) / k - 1, pad = (steps + 1) * k - 2 * S;
+
+			std::copy(x.begin(), x.end(), y.begin() + pad);
+
+			for (size_t i = 0; i < steps; i++)
+				Step(y.data() + i * k);
+
+			U result;
+			std::copy(y.begin() + steps * k, y.begin() + (steps + 1) * k, result.end() - k);
+
+			return result;
+		}
+
+		U Reduce(const U& x) const
+		{
+			W w;
+			std::copy(x.begin(), x.end(), w.begin() + S);
+
+			return Reduce(w);
+		}
+
+		U Multiply(const U& a, const U& b) const
+		{
+			return Reduce(MulWide(a, b));
+		}
+
+		U Square(const U& a) const
+		{
+			return Reduce(MulWide(a, a));
+		}
+	};
+}
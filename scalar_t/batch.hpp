@@ -0,0 +1,682 @@
+/* Copyright (C) 2020 D8DATAWORKS - All Rights Reserved */
+
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <utility>
+
+#include "int.hpp"
+
+/*
+	AVX2 backend for the batch kernels, compiled in when the target enables it ( -mavx2, /arch:AVX2 ).
+	Every kernel has a portable lane loop that also covers the N % lanes tail.
+*/
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define SCALAR_T_AVX2
+#endif
+
+namespace scalar_t
+{
+	namespace helper
+	{
+		namespace batch
+		{
+			//S rows of N lanes, row 0 holds the most significant limb of every integer
+			//
+			template < typename T, size_t S, size_t N > using rows_t = std::array<std::array<T, N>, S>;
+
+#if defined(SCALAR_T_AVX2)
+			template < typename T > constexpr size_t lanes = 32 / sizeof(T);
+
+			template < typename T > __m256i add(__m256i a, __m256i b)
+			{
+				if constexpr (sizeof(T) == 1) return _mm256_add_epi8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm256_add_epi16(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm256_add_epi32(a, b);
+				else return _mm256_add_epi64(a, b);
+			}
+
+			template < typename T > __m256i sub(__m256i a, __m256i b)
+			{
+				if constexpr (sizeof(T) == 1) return _mm256_sub_epi8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm256_sub_epi16(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm256_sub_epi32(a, b);
+				else return _mm256_sub_epi64(a, b);
+			}
+
+			template < typename T > __m256i eq(__m256i a, __m256i b)
+			{
+				if constexpr (sizeof(T) == 1) return _mm256_cmpeq_epi8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm256_cmpeq_epi16(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm256_cmpeq_epi32(a, b);
+				else return _mm256_cmpeq_epi64(a, b);
+			}
+
+			//Unsigned a < b per lane as an all ones mask, AVX2 only compares signed so both sides are biased by the sign bit.
+			//
+			template < typename T > __m256i lt(__m256i a, __m256i b)
+			{
+				if constexpr (sizeof(T) == 1)
+				{
+					__m256i s = _mm256_set1_epi8(char(0x80));
+					return _mm256_cmpgt_epi8(_mm256_xor_si256(b, s), _mm256_xor_si256(a, s));
+				}
+				else if constexpr (sizeof(T) == 2)
+				{
+					__m256i s = _mm256_set1_epi16(short(0x8000));
+					return _mm256_cmpgt_epi16(_mm256_xor_si256(b, s), _mm256_xor_si256(a, s));
+				}
+				else if constexpr (sizeof(T) == 4)
+				{
+					__m256i s = _mm256_set1_epi32(int(0x80000000));
+					return _mm256_cmpgt_epi32(_mm256_xor_si256(b, s), _mm256_xor_si256(a, s));
+				}
+				else
+				{
+					__m256i s = _mm256_set1_epi64x((long long)(1ull << 63));
+					return _mm256_cmpgt_epi64(_mm256_xor_si256(b, s), _mm256_xor_si256(a, s));
+				}
+			}
+
+			inline __m256i load(const void* p) { return _mm256_loadu_si256((const __m256i*)p); }
+			inline void store(void* p, __m256i v) { _mm256_storeu_si256((__m256i*)p, v); }
+
+			//First lane of every integer in a byte mask from movemask
+			//
+			template < typename T, size_t N > void set_mask(std::bitset<N>& r, size_t j, __m256i m)
+			{
+				uint32_t bits = uint32_t(_mm256_movemask_epi8(m));
+
+				for (size_t l = 0; l < lanes<T>; l++)
+					r[j + l] = (bits >> (l * sizeof(T))) & 1;
+			}
+#endif
+
+			//r = a + b, the carry of each lane stays a mask in a register across the limbs, the portable loop keeps one carry per integer and walks the rows without a flags chain so it can vectorize
+			//
+			template < typename T, size_t S, size_t N > void add_n(rows_t<T, S, N>& r, const rows_t<T, S, N>& a, const rows_t<T, S, N>& b)
+			{
+				size_t j = 0;
+
+#if defined(SCALAR_T_AVX2)
+				__m256i ones = _mm256_set1_epi8(-1);
+
+				for (; j + lanes<T> <= N; j += lanes<T>)
+				{
+					__m256i carry = _mm256_setzero_si256();
+
+					for (size_t i = S - 1; i != -1; i--)
+					{
+						//x + y generates a carry when it wraps and propagates the incoming one when it is all ones, neither waits on carry
+						//
+						__m256i x = load(&a[i][j]), s = add<T>(x, load(&b[i][j]));
+						__m256i g = lt<T>(s, x), p = eq<T>(s, ones);
+
+						store(&r[i][j], sub<T>(s, carry));
+
+						carry = _mm256_or_si256(g, _mm256_and_si256(p, carry));
+					}
+				}
+#endif
+
+				std::array<T, N> carry{};
+
+				for (size_t i = S - 1; i != -1; i--)
+				{
+					for (size_t l = j; l < N; l++)
+					{
+						T x = a[i][l], s = T(x + b[i][l]), c = s < x;
+
+						s = T(s + carry[l]);
+						carry[l] = c | (s < carry[l]);
+						r[i][l] = s;
+					}
+				}
+			}
+
+			//r = a - b, borrow as for add_n
+			//
+			template < typename T, size_t S, size_t N > void sub_n(rows_t<T, S, N>& r, const rows_t<T, S, N>& a, const rows_t<T, S, N>& b)
+			{
+				size_t j = 0;
+
+#if defined(SCALAR_T_AVX2)
+				for (; j + lanes<T> <= N; j += lanes<T>)
+				{
+					__m256i borrow = _mm256_setzero_si256();
+
+					for (size_t i = S - 1; i != -1; i--)
+					{
+						__m256i x = load(&a[i][j]), y = load(&b[i][j]), d = sub<T>(x, y);
+						__m256i c = _mm256_and_si256(borrow, eq<T>(d, _mm256_setzero_si256()));
+
+						d = add<T>(d, borrow);
+
+						borrow = _mm256_or_si256(lt<T>(x, y), c);
+
+						store(&r[i][j], d);
+					}
+				}
+#endif
+
+				std::array<T, N> borrow{};
+
+				for (size_t i = S - 1; i != -1; i--)
+				{
+					for (size_t l = j; l < N; l++)
+					{
+						T x = a[i][l], y = b[i][l], d = T(x - y), c = d < borrow[l];
+
+						r[i][l] = T(d - borrow[l]);
+						borrow[l] = (x < y) | c;
+					}
+				}
+			}
+
+			template < typename T, size_t S, size_t N > void xor_n(rows_t<T, S, N>& r, const rows_t<T, S, N>& a, const rows_t<T, S, N>& b)
+			{
+				for (size_t i = 0; i < S; i++)
+				{
+					size_t j = 0;
+
+#if defined(SCALAR_T_AVX2)
+					for (; j + lanes<T> <= N; j += lanes<T>)
+						store(&r[i][j], _mm256_xor_si256(load(&a[i][j]), load(&b[i][j])));
+#endif
+
+					for (; j < N; j++)
+						r[i][j] = a[i][j] ^ b[i][j];
+				}
+			}
+
+			//Bit j is set when integer j of a is below integer j of b, the first differing limb from the top decides.
+			//
+			template < typename T, size_t S, size_t N > std::bitset<N> less_n(const rows_t<T, S, N>& a, const rows_t<T, S, N>& b)
+			{
+				std::bitset<N> r;
+				size_t j = 0;
+
+#if defined(SCALAR_T_AVX2)
+				for (; j + lanes<T> <= N; j += lanes<T>)
+				{
+					__m256i less = _mm256_setzero_si256(), decided = _mm256_setzero_si256();
+
+					for (size_t i = 0; i < S; i++)
+					{
+						__m256i x = load(&a[i][j]), y = load(&b[i][j]);
+						__m256i l = lt<T>(x, y), g = lt<T>(y, x);
+
+						less = _mm256_or_si256(less, _mm256_andnot_si256(decided, l));
+						decided = _mm256_or_si256(decided, _mm256_or_si256(l, g));
+					}
+
+					set_mask<T>(r, j, less);
+				}
+#endif
+
+				std::bitset<N> decided;
+
+				for (size_t i = 0; i < S; i++)
+				{
+					for (size_t l = j; l < N; l++)
+					{
+						if (decided[l] || a[i][l] == b[i][l])
+							continue;
+
+						r[l] = a[i][l] < b[i][l];
+						decided[l] = true;
+					}
+				}
+
+				return r;
+			}
+
+			template < typename T, size_t S, size_t N > std::bitset<N> equal_n(const rows_t<T, S, N>& a, const rows_t<T, S, N>& b)
+			{
+				std::bitset<N> r;
+				size_t j = 0;
+
+#if defined(SCALAR_T_AVX2)
+				for (; j + lanes<T> <= N; j += lanes<T>)
+				{
+					__m256i e = _mm256_set1_epi8(-1);
+
+					for (size_t i = 0; i < S; i++)
+						e = _mm256_and_si256(e, eq<T>(load(&a[i][j]), load(&b[i][j])));
+
+					set_mask<T>(r, j, e);
+				}
+#endif
+
+				for (size_t l = j; l < N; l++)
+					r[l] = true;
+
+				for (size_t i = 0; i < S; i++)
+					for (size_t l = j; l < N; l++)
+						r[l] = r[l] && a[i][l] == b[i][l];
+
+				return r;
+			}
+
+#if defined(SCALAR_T_AVX2)
+			//Square block of the vector transpose, 4 x 4 for 64 bit limbs and 8 x 8 for 32 bit limbs, narrower limbs are gathered one by one
+			//
+			template < typename T > constexpr size_t block = (sizeof(T) == 8 || sizeof(T) == 4) ? lanes<T> : 0;
+
+			//x[k] lane l <-> x[l] lane k, its own inverse
+			//
+			template < typename T > void transpose_block(__m256i* x)
+			{
+				if constexpr (sizeof(T) == 8)
+				{
+					__m256i t0 = _mm256_unpacklo_epi64(x[0], x[1]), t1 = _mm256_unpackhi_epi64(x[0], x[1]);
+					__m256i t2 = _mm256_unpacklo_epi64(x[2], x[3]), t3 = _mm256_unpackhi_epi64(x[2], x[3]);
+
+					x[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+					x[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+					x[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+					x[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+				}
+				else
+				{
+					__m256i t0 = _mm256_unpacklo_epi32(x[0], x[1]), t1 = _mm256_unpackhi_epi32(x[0], x[1]);
+					__m256i t2 = _mm256_unpacklo_epi32(x[2], x[3]), t3 = _mm256_unpackhi_epi32(x[2], x[3]);
+					__m256i t4 = _mm256_unpacklo_epi32(x[4], x[5]), t5 = _mm256_unpackhi_epi32(x[4], x[5]);
+					__m256i t6 = _mm256_unpacklo_epi32(x[6], x[7]), t7 = _mm256_unpackhi_epi32(x[6], x[7]);
+
+					__m256i u0 = _mm256_unpacklo_epi64(t0, t2), u1 = _mm256_unpackhi_epi64(t0, t2);
+					__m256i u2 = _mm256_unpacklo_epi64(t1, t3), u3 = _mm256_unpackhi_epi64(t1, t3);
+					__m256i u4 = _mm256_unpacklo_epi64(t4, t6), u5 = _mm256_unpackhi_epi64(t4, t6);
+					__m256i u6 = _mm256_unpacklo_epi64(t5, t7), u7 = _mm256_unpackhi_epi64(t5, t7);
+
+					x[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+					x[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+					x[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+					x[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+					x[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+					x[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+					x[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+					x[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+				}
+			}
+
+			//Row i .. i + w of integers j .. j + w through one register block, the index sequence unrolls it so the block stays in registers
+			//
+			template < typename T, typename L, typename St, size_t... k > void transpose_step(L ld, St st, std::index_sequence<k...>)
+			{
+				__m256i x[sizeof...(k)] = { ld(k)... };
+
+				transpose_block<T>(x);
+
+				(st(k, x[k]), ...);
+			}
+#else
+			template < typename T > constexpr size_t block = 0;
+#endif
+
+			//AoS -> SoA, whole blocks of block<T> integers and limbs go through transpose_block, the limbs past the last block row
+			//and the integers past the last block column are gathered one by one.
+			//
+			template < typename T, size_t S, size_t N > void transpose_in(rows_t<T, S, N>& r, const uintv_t<T, S>* v)
+			{
+				constexpr size_t w = block<T>, vn = w ? N / w * w : 0, vs = w ? S / w * w : 0;
+
+#if defined(SCALAR_T_AVX2)
+				if constexpr (w > 0)
+				{
+					for (size_t j = 0; j < vn; j += w)
+					{
+						for (size_t i = 0; i < vs; i += w)
+							transpose_step<T>([&](size_t k) { return load(&v[j + k][i]); }, [&](size_t k, __m256i x) { store(&r[i + k][j], x); }, std::make_index_sequence<w>());
+
+						for (size_t i = vs; i < S; i++)
+							for (size_t k = 0; k < w; k++)
+								r[i][j + k] = v[j + k][i];
+					}
+				}
+#endif
+
+				for (size_t j = vn; j < N; j++)
+					for (size_t i = 0; i < S; i++)
+						r[i][j] = v[j][i];
+			}
+
+			//SoA -> AoS, the same blocks in the other direction
+			//
+			template < typename T, size_t S, size_t N > void transpose_out(uintv_t<T, S>* v, const rows_t<T, S, N>& r)
+			{
+				constexpr size_t w = block<T>, vn = w ? N / w * w : 0, vs = w ? S / w * w : 0;
+
+#if defined(SCALAR_T_AVX2)
+				if constexpr (w > 0)
+				{
+					for (size_t j = 0; j < vn; j += w)
+					{
+						for (size_t i = 0; i < vs; i += w)
+							transpose_step<T>([&](size_t k) { return load(&r[i + k][j]); }, [&](size_t k, __m256i x) { store(&v[j + k][i], x); }, std::make_index_sequence<w>());
+
+						for (size_t i = vs; i < S; i++)
+							for (size_t k = 0; k < w; k++)
+								v[j + k][i] = r[i][j + k];
+					}
+				}
+#endif
+
+				for (size_t j = vn; j < N; j++)
+					for (size_t i = 0; i < S; i++)
+						v[j][i] = r[i][j];
+			}
+
+			//Reduced radix for the multi-buffer multiply, 28 bit digits while a column of digit products still fits 64 bits, 26 above that
+			//
+			template < typename T, size_t S > constexpr size_t mul_radix = (S * bits<T>() + 27) / 28 < 256 ? 28 : 26;
+
+			template < typename T, size_t S > constexpr size_t mul_digits = (S * bits<T>() + mul_radix<T, S> - 1) / mul_radix<T, S>;
+
+			//64 bit limbs keep the scalar mulx kernel until the product is wide enough for the vector columns to catch up
+			//
+			template < typename T, size_t S > constexpr bool vector_mul = sizeof(T) < 8 || S >= 16;
+
+#if defined(SCALAR_T_AVX2)
+			inline __m256i shr64(__m256i v, size_t n) { return _mm256_srl_epi64(v, _mm_cvtsi64_si128((long long)n)); }
+			inline __m256i shl64(__m256i v, size_t n) { return _mm256_sll_epi64(v, _mm_cvtsi64_si128((long long)n)); }
+
+			//Limb i of lanes j .. j + 3 zero extended to 64 bit lanes
+			//
+			template < typename T, size_t S, size_t N > __m256i load_limb(const rows_t<T, S, N>& a, size_t i, size_t j)
+			{
+				if constexpr (sizeof(T) == 8)
+					return load(&a[i][j]);
+				else
+					return _mm256_set_epi64x((long long)a[i][j + 3], (long long)a[i][j + 2], (long long)a[i][j + 1], (long long)a[i][j]);
+			}
+
+			template < typename T, size_t S, size_t N > void store_limb(rows_t<T, S, N>& r, size_t i, size_t j, __m256i v)
+			{
+				if constexpr (sizeof(T) == 8)
+					store(&r[i][j], v);
+				else
+				{
+					alignas(32) uint64_t t[4];
+					_mm256_store_si256((__m256i*)t, v);
+
+					for (size_t l = 0; l < 4; l++)
+						r[i][j + l] = T(t[l]);
+				}
+			}
+
+			//Splits lanes j .. j + 3 of a into radix digits, least significant first
+			//
+			template < typename T, size_t S, size_t N > void to_digits(__m256i* d, const rows_t<T, S, N>& a, size_t j)
+			{
+				constexpr size_t radix = mul_radix<T, S>, D = mul_digits<T, S>, b = bits<T>();
+
+				__m256i mask = _mm256_set1_epi64x((long long)((1ull << radix) - 1)), acc = _mm256_setzero_si256();
+				size_t have = 0, k = 0;
+
+				for (size_t i = S - 1; i != -1; i--)
+				{
+					__m256i v = load_limb<T, S, N>(a, i, j);
+
+					for (size_t used = 0; used < b; )
+					{
+						size_t take = std::min(b - used, radix - have);
+
+						acc = _mm256_or_si256(acc, shl64(shr64(v, used), have));
+						have += take;
+						used += take;
+
+						if (have == radix)
+						{
+							d[k++] = _mm256_and_si256(acc, mask);
+							acc = _mm256_setzero_si256();
+							have = 0;
+						}
+					}
+				}
+
+				if (k < D)
+					d[k] = _mm256_and_si256(acc, mask);
+			}
+
+			//Packs normalized digits back into limbs of lanes j .. j + 3, bits past S * b are dropped
+			//
+			template < typename T, size_t S, size_t N > void from_digits(rows_t<T, S, N>& r, const __m256i* d, size_t j)
+			{
+				constexpr size_t radix = mul_radix<T, S>, D = mul_digits<T, S>, b = bits<T>();
+
+				__m256i mask = _mm256_set1_epi64x(b == 64 ? -1ll : (long long)((1ull << b) - 1));
+				size_t k = 0, used = 0;
+
+				for (size_t i = S - 1; i != -1; i--)
+				{
+					__m256i v = _mm256_setzero_si256();
+
+					for (size_t have = 0; have < b && k < D; )
+					{
+						size_t take = std::min(b - have, radix - used);
+
+						v = _mm256_or_si256(v, shl64(shr64(d[k], used), have));
+						have += take;
+						used += take;
+
+						if (used == radix)
+						{
+							k++;
+							used = 0;
+						}
+					}
+
+					store_limb<T, S, N>(r, i, j, _mm256_and_si256(v, mask));
+				}
+			}
+#endif
+
+			//r = a * b mod 2^n per integer. Under AVX2 four integers at a time go to radix 2^26 / 2^28 digits in 64 bit lanes,
+			//every digit product is one vpmuludq added into its column without carries, the columns are normalized once at the end.
+			//
+			template < typename T, size_t S, size_t N > void mul_n(rows_t<T, S, N>& r, const rows_t<T, S, N>& a, const rows_t<T, S, N>& b)
+			{
+				size_t j = 0;
+
+#if defined(SCALAR_T_AVX2)
+				constexpr size_t radix = mul_radix<T, S>, D = mul_digits<T, S>;
+
+				static_assert(D < (size_t(1) << (64 - 2 * radix)), "digit columns must not overflow 64 bits");
+
+				for (; vector_mul<T, S> && j + 4 <= N; j += 4)
+				{
+					__m256i x[D], y[D], c[D];
+
+					to_digits<T, S, N>(x, a, j);
+					to_digits<T, S, N>(y, b, j);
+
+					for (size_t k = 0; k < D; k++)
+					{
+						__m256i s0 = _mm256_mul_epu32(x[0], y[k]), s1 = _mm256_setzero_si256();
+						size_t i = 1;
+
+						for (; i + 1 <= k; i += 2)
+						{
+							s0 = _mm256_add_epi64(s0, _mm256_mul_epu32(x[i], y[k - i]));
+							s1 = _mm256_add_epi64(s1, _mm256_mul_epu32(x[i + 1], y[k - i - 1]));
+						}
+
+						if (i <= k)
+							s0 = _mm256_add_epi64(s0, _mm256_mul_epu32(x[i], y[k - i]));
+
+						c[k] = _mm256_add_epi64(s0, s1);
+					}
+
+					__m256i mask = _mm256_set1_epi64x((long long)((1ull << radix) - 1)), carry = _mm256_setzero_si256();
+
+					for (size_t k = 0; k < D; k++)
+					{
+						__m256i s = _mm256_add_epi64(c[k], carry);
+
+						carry = shr64(s, radix);
+						c[k] = _mm256_and_si256(s, mask);
+					}
+
+					from_digits<T, S, N>(r, c, j);
+				}
+#endif
+
+				for (; j < N; j++)
+				{
+					uintv_t<T, S> x, y;
+
+					for (size_t i = 0; i < S; i++)
+					{
+						x[i] = a[i][j];
+						y[i] = b[i][j];
+					}
+
+					x *= y;
+
+					for (size_t i = 0; i < S; i++)
+						r[i][j] = x[i];
+				}
+			}
+		}
+	}
+
+	/*
+		N integers of S limbs in structure of arrays form, limb i of every integer is contiguous so one
+		instruction works on lanes<T> integers at once, 4 with 64 bit limbs and 8 with 32 bit limbs under AVX2.
+		Arithmetic wraps modulo 2^n per integer like uintv_t, multiplication runs four integers per pass in reduced radix, see mul_n.
+	*/
+
+	template < typename T, size_t S, size_t N > class uintv_batch
+	{
+		using U = uintv_t<T, S>;
+		using V = uintv_batch<T, S, N>;
+
+		alignas(32) helper::batch::rows_t<T, S, N> limb{};
+
+	public:
+
+		uintv_batch() {}
+
+		explicit uintv_batch(const U* values)
+		{
+			Load(values);
+		}
+
+		void Load(const U* values)
+		{
+			helper::batch::transpose_in<T, S, N>(limb, values);
+		}
+
+		void Store(U* values) const
+		{
+			helper::batch::transpose_out<T, S, N>(values, limb);
+		}
+
+		U operator[](size_t j) const
+		{
+			U r;
+
+			for (size_t i = 0; i < S; i++)
+				r[i] = limb[i][j];
+
+			return r;
+		}
+
+		void Set(size_t j, const U& v)
+		{
+			for (size_t i = 0; i < S; i++)
+				limb[i][j] = v[i];
+		}
+
+		//Row i, limb i of all N integers
+		//
+		T* Limb(size_t i) { return limb[i].data(); }
+		const T* Limb(size_t i) const { return limb[i].data(); }
+
+		V operator + (const V& r) const
+		{
+			V result;
+
+			helper::batch::add_n<T, S, N>(result.limb, limb, r.limb);
+
+			return result;
+		}
+
+		V operator - (const V& r) const
+		{
+			V result;
+
+			helper::batch::sub_n<T, S, N>(result.limb, limb, r.limb);
+
+			return result;
+		}
+
+		V operator ^ (const V& r) const
+		{
+			V result;
+
+			helper::batch::xor_n<T, S, N>(result.limb, limb, r.limb);
+
+			return result;
+		}
+
+		V operator * (const V& r) const
+		{
+			V result;
+
+			helper::batch::mul_n<T, S, N>(result.limb, limb, r.limb);
+
+			return result;
+		}
+
+		V& operator *= (const V& r)
+		{
+			helper::batch::mul_n<T, S, N>(limb, limb, r.limb);
+
+			return *this;
+		}
+
+		V& operator += (const V& r)
+		{
+			helper::batch::add_n<T, S, N>(limb, limb, r.limb);
+
+			return *this;
+		}
+
+		V& operator -= (const V& r)
+		{
+			helper::batch::sub_n<T, S, N>(limb, limb, r.limb);
+
+			return *this;
+		}
+
+		V& operator ^= (const V& r)
+		{
+			helper::batch::xor_n<T, S, N>(limb, limb, r.limb);
+
+			return *this;
+		}
+
+		//Bit j is set when integer j is below integer j of r
+		//
+		std::bitset<N> Less(const V& r) const
+		{
+			return helper::batch::less_n<T, S, N>(limb, r.limb);
+		}
+
+		std::bitset<N> Equal(const V& r) const
+		{
+			return helper::batch::equal_n<T, S, N>(limb, r.limb);
+		}
+
+		bool operator == (const V& r) const
+		{
+			return limb == r.limb;
+		}
+	};
+}
@@ -1,10 +1,15 @@
 #pragma once
 
-#include <intrin.h>
-#pragma intrinsic(_umul128)
-#pragma intrinsic(_addcarryx_u64)
-
 #include <tuple>
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <type_traits>
+#include <vector>
+#include <cmath>
+
+#include "intrinsic.hpp"
+#include "adx.hpp"
 
 namespace scalar_t
 {
@@ -25,44 +30,16 @@ namespace scalar_t
 				4 4 4
 		*/
 
-		//WARNING: Little Endian
-		template <typename S, typename L> auto mut(const S& s1, const S& s2)
-		{
-			union
-			{
-				S s[2];
-				L l;
-			};
-
-			l = (L)s1 * (L)s2;
-
-			return std::make_pair(s[1], s[0]);
-		}
-
 		template < typename T > auto mul(const T& t1, const T& t2)
 		{
-			if constexpr (std::is_same<T, uint8_t>())
-				return mut<T, uint16_t>(t1, t2);
-			if constexpr (std::is_same<T, uint16_t>())
-				return mut<T, uint32_t>(t1, t2);
-			if constexpr (std::is_same<T, uint32_t>())
-				return mut<T, uint64_t>(t1, t2);
-			if constexpr (std::is_same<T, uint64_t>())
-			{
-				uint64_t lw, hh;
-				lw = _umul128(t1, t2, &hh);
-
-				return std::make_pair(hh, lw);
-			}
+			return intrinsic::umul<T>(t1, t2);
 		}
 
 		template < typename T1, typename T2 > bool add(T1& t1, const T2& t2)
 		{
-			t1 += t2;
-			return t2 > t1;
+			return intrinsic::addc<T1>(0, t1, T1(t2), t1);
 		}
 
-		//TODO intrinsic https://stackoverflow.com/questions/29229371/addcarry-u64-and-addcarryx-u64-with-msvc-and-icc#:~:text=The%20documentation%20for%20MSVC%20lists,_addcarry_u64%20has%20no%20listed%20technology.&text=The%20_addcarry_u64%20intrinsic%20documentation%20says,produce%20either%20adcx%20or%20adox%20.
 		template < typename C, typename T > bool vad(C& c, size_t i, const T& v)
 		{
 			bool carry = add(c[i], v);
@@ -75,9 +52,7 @@ namespace scalar_t
 
 		template < typename T1, typename T2 > bool sub(T1& t1, const T2& t2)
 		{
-			bool carry = t2 > t1;
-			t1 -= t2;
-			return carry;
+			return intrinsic::subb<T1>(0, t1, T1(t2), t1);
 		}
 
 		template < typename C, typename T > bool vsb(C& c, size_t i, const T& v)
@@ -90,7 +65,7 @@ namespace scalar_t
 			return carry;
 		}
 
-		template< typename T > size_t bits()
+		template< typename T > constexpr size_t bits()
 		{
 			if constexpr (std::is_same<T, uint8_t>())
 				return 8;
@@ -160,31 +135,422 @@ namespace scalar_t
 					pnext = rsh(c[i], pnext, b);
 		}
 
-		template <typename C1, typename C2, typename R> bool finite_vector_subtract(const C1& v1, const C2& v2, R& result)
+		template < typename T, size_t S > std::integral_constant<size_t, S> extent(const std::array<T, S>&);
+
+		template < typename C > constexpr size_t limbs = decltype(extent(std::declval<const C&>()))::value;
+
+		/*
+			Single pass carry chains, least significant limb ( back() ) to most significant ( front() ).
+			The index sequence unrolls the chain for each S, the result may alias either operand.
+		*/
+
+		template <typename T, typename C1, typename C2, typename R, size_t ... I> bool add_chain(const C1& v1, const C2& v2, R& result, std::index_sequence<I...>)
 		{
-			bool overflow = false;
-			std::copy(v1.begin(), v1.end(), result.begin());
+			constexpr size_t n = sizeof...(I) - 1;
+			unsigned char carry = 0;
 
-			for (size_t i = 0; i < v1.size(); i++)
-				if (vsb(result, i, v2[i]))
-					overflow = true;
+			((carry = intrinsic::addc<T>(carry, v1[n - I], v2[n - I], result[n - I])), ...);
+
+			return carry;
+		}
+
+		template <typename T, typename C1, typename C2, typename R, size_t ... I> bool sub_chain(const C1& v1, const C2& v2, R& result, std::index_sequence<I...>)
+		{
+			constexpr size_t n = sizeof...(I) - 1;
+			unsigned char borrow = 0;
+
+			((borrow = intrinsic::subb<T>(borrow, v1[n - I], v2[n - I], result[n - I])), ...);
+
+			return borrow;
+		}
 
-			return overflow;
+		template <typename C1, typename C2, typename R> bool finite_vector_subtract(const C1& v1, const C2& v2, R& result)
+		{
+			return sub_chain<typename C1::value_type>(v1, v2, result, std::make_index_sequence<limbs<C1>>());
 		}
 
 		template <typename C1, typename C2> bool finite_vector_subtract(C1& v1, const C2& v2)
 		{
-			bool overflow = false;
+			return sub_chain<typename C1::value_type>(v1, v2, v1, std::make_index_sequence<limbs<C1>>());
+		}
 
-			for (size_t i = 0; i < v1.size(); i++)
-				if (vsb(v1, i, v2[i]))
-					overflow = true;
+		template <typename C1, typename C2, typename R> bool finite_vector_add(const C1& v1, const C2& v2, R& result)
+		{
+			return add_chain<typename C1::value_type>(v1, v2, result, std::make_index_sequence<limbs<C1>>());
+		}
+
+		template <typename C1, typename C2> bool finite_vector_add(C1& v1, const C2& v2)
+		{
+			return add_chain<typename C1::value_type>(v1, v2, v1, std::make_index_sequence<limbs<C1>>());
+		}
+
+		/*
+			Widening multiplication on raw limb ranges, most significant limb first like std::array storage.
+			n limbs x n limbs -> 2n limbs.
+		*/
+
+		template < typename T > unsigned char add_n(T* r, const T* a, const T* b, size_t n)
+		{
+			unsigned char carry = 0;
+
+			for (size_t i = n - 1; i != -1; i--)
+				carry = intrinsic::addc<T>(carry, a[i], b[i], r[i]);
+
+			return carry;
+		}
+
+		template < typename T > unsigned char sub_n(T* r, const T* a, const T* b, size_t n)
+		{
+			unsigned char borrow = 0;
+
+			for (size_t i = n - 1; i != -1; i--)
+				borrow = intrinsic::subb<T>(borrow, a[i], b[i], r[i]);
+
+			return borrow;
+		}
+
+		template < typename T > bool less_n(const T* a, const T* b, size_t n)
+		{
+			for (size_t i = 0; i < n; i++)
+				if (a[i] != b[i])
+					return a[i] < b[i];
+
+			return false;
+		}
+
+		//Full product scanning kernel, the same column walk as finite_vector_multiply without truncation.
+		//
+		template < typename T > void mul_basecase(const T* a, const T* b, size_t n, T* r)
+		{
+#if defined(SCALAR_T_ADX)
+			if constexpr (std::is_same_v<T, uint64_t>)
+				if (intrinsic::bmi2_adx && n >= adx::threshold)
+					return adx::mul_basecase(a, b, n, r);
+#endif
+
+			T c0 = 0, c1 = 0, c2 = 0;
+
+			for (size_t p = 0; p < 2 * n - 1; p++)
+			{
+				size_t lo = (p < n) ? 0 : p - n + 1, hi = (p < n) ? p : n - 1;
+
+				for (size_t i = lo; i <= hi; i++)
+				{
+					auto [h, l] = mul(a[n - 1 - i], b[n - 1 - p + i]);
+
+					c2 += intrinsic::addc<T>(intrinsic::addc<T>(0, c0, l, c0), c1, h, c1);
+				}
+
+				r[2 * n - 1 - p] = c0;
+				c0 = c1; c1 = c2; c2 = 0;
+			}
+
+			r[0] = c0;
+		}
+
+		/*
+			Product scanning ( Comba ) truncated multiplication, r = a * b mod B^n.
+
+			Column p of the product ( counted from the last limb ) is summed into the three word accumulator c0:c1:c2,
+			then c0 is written to the result exactly once and the accumulator shifts down a word.
+			The final column only contributes to the low word, so its high halves are never formed.
+		*/
+
+		template < typename T > void mullo_basecase(const T* a, const T* b, size_t _n, T* r)
+		{
+#if defined(SCALAR_T_ADX)
+			if constexpr (std::is_same_v<T, uint64_t>)
+				if (intrinsic::bmi2_adx && _n >= adx::threshold)
+					return adx::mullo_basecase(a, b, _n, r);
+#endif
+
+			size_t n = _n - 1;
+			T c0 = 0, c1 = 0, c2 = 0;
+
+			for (size_t p = 0; p < n; p++)
+			{
+				for (size_t i = 0; i <= p; i++)
+				{
+					auto [h, l] = mul(a[n - i], b[n - p + i]);
+
+					c2 += intrinsic::addc<T>(intrinsic::addc<T>(0, c0, l, c0), c1, h, c1);
+				}
+
+				r[n - p] = c0;
+				c0 = c1; c1 = c2; c2 = 0;
+			}
+
+			for (size_t i = 0; i <= n; i++)
+				c0 += mul(a[n - i], b[i]).second;
+
+			r[0] = c0;
+		}
+
+#ifndef SCALAR_T_KARATSUBA_THRESHOLD
+#define SCALAR_T_KARATSUBA_THRESHOLD 32
+#endif
+
+		//Limb count below which karatsuba() falls back to mul_basecase().
+		//
+		constexpr size_t karatsuba_threshold = SCALAR_T_KARATSUBA_THRESHOLD;
+
+		static_assert(karatsuba_threshold >= 2, "karatsuba() must not split a single limb");
+
+		//Differences and their product take 4 * ceil( n / 2 ) limbs per level, the recursion continues on the longer half.
+		//
+		constexpr size_t karatsuba_scratch(size_t n)
+		{
+			return (n < karatsuba_threshold) ? 0 : 4 * (n - n / 2) + karatsuba_scratch(n - n / 2);
+		}
+
+		//r = | a - b | over n limbs, b holds the low n - d limbs and its top d limbs count as zero, returns a < b
+		//
+		template < typename T > bool sub_abs_pad_n(T* r, const T* a, const T* b, size_t n, size_t d)
+		{
+			if (!(d && a[0]) && less_n(a + d, b, n - d))
+			{
+				sub_n(r + d, b, a + d, n - d);
+				std::fill(r, r + d, T(0));
+
+				return true;
+			}
+
+			T borrow = sub_n(r + d, a + d, b, n - d);
+			std::copy(a, a + d, r);
+
+			if (borrow && d)
+				vsb(r, d - 1, borrow);
+
+			return false;
+		}
+
+		//r = a + b over n limbs, b holds the low n - d limbs and its top d limbs count as zero, returns the carry
+		//
+		template < typename T > T add_pad_n(T* r, const T* a, const T* b, size_t n, size_t d)
+		{
+			T carry = add_n(r + d, a + d, b, n - d);
+			std::copy(a, a + d, r);
+
+			if (carry && d)
+				carry = vad(r, d - 1, carry);
+
+			return carry;
+		}
+
+		/*
+			Subtractive Karatsuba, r = a * b with 2n result limbs.
+
+			a = ah * B^l + al, b = bh * B^l + bl with l = n - n / 2, an odd n leaves ah and bh one limb shorter
+			middle = al * bl + ah * bh - (al - ah) * (bl - bh)
+
+			scratch must hold karatsuba_scratch(n) limbs.
+		*/
+
+		template < typename T > void karatsuba(const T* a, const T* b, size_t n, T* r, T* scratch)
+		{
+			if (n < karatsuba_threshold)
+				return mul_basecase(a, b, n, r);
+
+			size_t h = n / 2, l = n - h, d = l - h;
+
+			const T* ah = a, * al = a + h, * bh = b, * bl = b + h;
+
+			karatsuba(al, bl, l, r + 2 * h, scratch);
+			karatsuba(ah, bh, h, r, scratch);
+
+			T* da = scratch, * db = scratch + l, * dd = scratch + 2 * l;
+
+			bool sa = sub_abs_pad_n(da, al, ah, l, d);
+			bool sb = sub_abs_pad_n(db, bl, bh, l, d);
+
+			karatsuba(da, db, l, dd, scratch + 4 * l);
+
+			T* middle = scratch;
+			T c = add_pad_n(middle, r + 2 * h, r, 2 * l, 2 * d);
 
-			return overflow;
+			if (sa == sb)
+				c -= sub_n(middle, middle, dd, 2 * l);
+			else
+				c += add_n(middle, middle, dd, 2 * l);
+
+			c += add_n(r + h - d, r + h - d, middle, 2 * l);
+
+			if (c)
+				vad(r, h - d - 1, c);
+		}
+
+#ifndef SCALAR_T_SHORT_PRODUCT_THRESHOLD
+#define SCALAR_T_SHORT_PRODUCT_THRESHOLD 96
+#endif
+
+		//Limb count at which truncated products switch from mullo_basecase() to mulders().
+		//
+		constexpr size_t short_product_threshold = SCALAR_T_SHORT_PRODUCT_THRESHOLD;
+
+		constexpr size_t short_product_scratch(size_t n) { return 6 * n; }
+
+		//Number of low limbs formed by the full karatsuba() product, at least half of n and a multiple of 4 so the first levels split evenly.
+		//
+		constexpr size_t mulders_split(size_t n)
+		{
+			size_t k = (n * 7 + 9) / 10;
+
+			return (k + 3) & ~size_t(3);
+		}
+
+		/*
+			Mulders short product, r = a * b mod B^n.
+
+			a = ah * B^k + al, b = bh * B^k + bl, with k >= n / 2 so ah * bh lands entirely above B^n:
+
+			r = al * bl + B^k * ( ah * bl + al * bh ) mod B^n
+
+			al * bl is a full karatsuba() product, the two cross terms are themselves short products of n - k limbs.
+			scratch must hold short_product_scratch(n) limbs.
+		*/
+
+		template < typename T > void mulders(const T* a, const T* b, size_t n, T* r, T* scratch)
+		{
+			if (n < short_product_threshold)
+				return mullo_basecase(a, b, n, r);
+
+			size_t k = mulders_split(n);
+
+			if (k >= n)
+				return mullo_basecase(a, b, n, r);
+
+			size_t h = n - k;
+
+			T* full = scratch;
+
+			karatsuba(a + h, b + h, k, full, scratch + 2 * k);
+			std::copy(full + 2 * k - n, full + 2 * k, r);
+
+			T* cross = scratch;
+
+			mulders(a, b + k, h, cross, scratch + h);
+			add_n(r, r, cross, h);
+
+			mulders(a + k, b, h, cross, scratch + h);
+			add_n(r, r, cross, h);
+		}
+
+		/*
+			Squaring, each cross product a[i] * a[j] with i < j is formed once and the column is doubled before the diagonal term is added.
+			sqr_basecase writes the low m limbs of a^2 ( m <= 2n ), m = 2n is the full square and m = n the truncated one.
+		*/
+
+		template < typename T > void sqr_basecase(const T* a, size_t n, T* r, size_t m)
+		{
+			constexpr size_t top = bits<T>() - 1;
+			T c0 = 0, c1 = 0, c2 = 0;
+
+			for (size_t p = 0; p < m; p++)
+			{
+				T t0 = 0, t1 = 0, t2 = 0;
+
+				for (size_t i = (p < n) ? 0 : p - n + 1; 2 * i < p; i++)
+				{
+					auto [h, l] = mul(a[n - 1 - i], a[n - 1 - p + i]);
+
+					t2 += intrinsic::addc<T>(intrinsic::addc<T>(0, t0, l, t0), t1, h, t1);
+				}
+
+				t2 = (t2 << 1) | (t1 >> top);
+				t1 = (t1 << 1) | (t0 >> top);
+				t0 <<= 1;
+
+				if (!(p & 1) && p / 2 < n)
+				{
+					auto [h, l] = mul(a[n - 1 - p / 2], a[n - 1 - p / 2]);
+
+					t2 += intrinsic::addc<T>(intrinsic::addc<T>(0, t0, l, t0), t1, h, t1);
+				}
+
+				c2 += t2 + intrinsic::addc<T>(intrinsic::addc<T>(0, c0, t0, c0), c1, t1, c1);
+
+				r[m - 1 - p] = c0;
+				c0 = c1; c1 = c2; c2 = 0;
+			}
+		}
+
+		//Karatsuba squaring, middle = al^2 + ah^2 - (al - ah)^2 so the difference term is never negative.
+		//
+		template < typename T > void karatsuba_sqr(const T* a, size_t n, T* r, T* scratch)
+		{
+			if (n < karatsuba_threshold)
+				return sqr_basecase(a, n, r, 2 * n);
+
+			size_t h = n / 2, l = n - h, d = l - h;
+
+			const T* ah = a, * al = a + h;
+
+			karatsuba_sqr(al, l, r + 2 * h, scratch);
+			karatsuba_sqr(ah, h, r, scratch);
+
+			T* da = scratch, * dd = scratch + 2 * l;
+
+			sub_abs_pad_n(da, al, ah, l, d);
+
+			karatsuba_sqr(da, l, dd, scratch + 4 * l);
+
+			T* middle = scratch;
+			T c = add_pad_n(middle, r + 2 * h, r, 2 * l, 2 * d);
+
+			c -= sub_n(middle, middle, dd, 2 * l);
+			c += add_n(r + h - d, r + h - d, middle, 2 * l);
+
+			if (c)
+				vad(r, h - d - 1, c);
+		}
+
+		//Mulders short square, both cross terms of mulders() are the same short product ah * al, which is added twice.
+		//
+		template < typename T > void mulders_sqr(const T* a, size_t n, T* r, T* scratch)
+		{
+			if (n < short_product_threshold)
+				return sqr_basecase(a, n, r, n);
+
+			size_t k = mulders_split(n);
+
+			if (k >= n)
+				return sqr_basecase(a, n, r, n);
+
+			size_t h = n - k;
+
+			T* full = scratch;
+
+			karatsuba_sqr(a + h, k, full, scratch + 2 * k);
+			std::copy(full + 2 * k - n, full + 2 * k, r);
+
+			T* cross = scratch;
+
+			mulders(a, a + k, h, cross, scratch + h);
+			add_n(r, r, cross, h);
+			add_n(r, r, cross, h);
+		}
+
+		template <typename T, typename C1, typename C2, typename R> void finite_vector_multiply_wide(const C1& v1, const C2& v2, R& result)
+		{
+			constexpr size_t n = limbs<C1>;
+			static_assert(limbs<R> == 2 * n, "widening multiply needs a 2S limb result");
+
+			std::array<T, karatsuba_scratch(n)> scratch;
+
+			if ((const void*)&v1 == (const void*)&v2)
+				karatsuba_sqr<T>(v1.data(), n, result.data(), scratch.data());
+			else
+				karatsuba<T>(v1.data(), v2.data(), n, result.data(), scratch.data());
 		}
 
 		template <typename C1, typename C2, typename A> void finite_vector_fuse_multiply_add(const C1& v1, const C2& v2, A& accumulate)
 		{
+#if defined(SCALAR_T_ADX)
+			if constexpr (std::is_same_v<typename A::value_type, uint64_t> && limbs<A> >= adx::threshold)
+				if (intrinsic::bmi2_adx)
+					return adx::addmullo(v1.data(), v2.data(), limbs<A>, accumulate.data());
+#endif
+
 			for (size_t j = 0, k = v1.size() - 1; j < v1.size(); j++, k--)
 				accumulate[0] += v1[j] * v2[k];
 
@@ -237,17 +603,25 @@ namespace scalar_t
 			finite_vector_inverse_add<T>(accumulate, v2);
 		}
 
-		template <typename T, typename C1, typename C2, typename C3, typename A> void finite_vector_fuse_multiply3_invadd(const C1& v1, const C2& _v2, const C3& v3, A& accumulate)
+		template <typename T, typename C1, typename C2, typename A> void finite_vector_fuse_multiply2_invadd(const C1& v1, const C2& v2, A& accumulate)
 		{
-			auto v2 = _v2 * v3;
+#if defined(SCALAR_T_ADX)
+			if constexpr (std::is_same_v<T, uint64_t> && limbs<A> >= adx::threshold)
+			{
+				if (intrinsic::bmi2_adx)
+				{
+					constexpr size_t n = limbs<A>;
 
-			finite_vector_fuse_multiply2_invadd<T>(v1, v2, accumulate);
-		}
+					std::array<T, n> p;
 
-		
+					adx::mullo_basecase(v1.data(), v2.data(), n, p.data());
+					sub_n(accumulate.data(), accumulate.data(), p.data(), n);
+
+					return;
+				}
+			}
+#endif
 
-		template <typename T, typename C1, typename C2, typename A> void finite_vector_fuse_multiply2_invadd(const C1& v1, const C2& v2, A& accumulate)
-		{
 			size_t i = v1.size() - 1;
 			T c = 0, n = 0, t3 = 0; // Matrix overflow condition possible with very bad configurations. bits<T> FF * FF coverage
 
@@ -309,73 +683,60 @@ namespace scalar_t
 			accumulate[0] += inv;
 		}
 
-		template <typename T, typename C1, typename C2, typename R> void finite_vector_multiply(const C1& v1, const C2& v2, R& result)
+		template <typename T, typename C1, typename C2, typename C3, typename A> void finite_vector_fuse_multiply3_invadd(const C1& v1, const C2& _v2, const C3& v3, A& accumulate)
 		{
-			for (size_t j = 0, k = v1.size() - 1; j < v1.size(); j++, k--)
-			{
-				result[j] = 0;
-				result[0] += v1[j] * v2[k];
-			}
-
-			for (size_t i = 1; i < v1.size(); i++)
-			{
-				for (size_t j = i, k = v1.size() - 1; j < v1.size(); j++, k--)
-				{
-					auto [h, l] = mul(v1[j], v2[k]);
+			auto v2 = _v2 * v3;
 
-					vad(result, i, l);
-					vad(result, i - 1, h);
-				}
-			}
+			finite_vector_fuse_multiply2_invadd<T>(v1, v2, accumulate);
 		}
 
-		template <typename T, typename C1, typename C2> void finite_vector_multiply(C1& v1, const C2& v2)
+		template <typename T, typename C, typename R> void finite_vector_square(const C& v, R& result)
 		{
-			for (size_t j = 0, k = v1.size() - 1; j < v1.size(); j++, k--)
-			{
-				if (!j)
-					v1[0] = v1[j] * v2[k];
-				else
-					v1[0] += v1[j] * v2[k];
-			}
+			constexpr size_t n = limbs<C>;
 
-			for (size_t i = 1; i < v1.size(); i++)
+			if constexpr (n >= short_product_threshold)
 			{
-				for (size_t j = i, k = v1.size() - 1; j < v1.size(); j++, k--)
-				{
-					auto [h, l] = mul(v1[j], v2[k]);
+				std::array<T, short_product_scratch(n)> scratch;
 
-					if (j == i)
-						v1[j] = 0;
-
-					vad(v1, i, l);
-					vad(v1, i - 1, h);
-				}
+				mulders_sqr<T>(v.data(), n, result.data(), scratch.data());
 			}
+			else
+				sqr_basecase<T>(v.data(), n, result.data(), n);
 		}
 
-		template <typename C1, typename C2, typename R> bool finite_vector_add(const C1& v1, const C2& v2, R& result)
+		template <typename T, typename C> void finite_vector_square(C& v)
 		{
-			bool overflow = false;
+			const C t = v;
 
-			std::copy(v1.begin(), v1.end(), result.begin());
+			finite_vector_square<T>(t, v);
+		}
 
-			for (size_t i = 0; i < v1.size(); i++)
-				if (vad(result, i, v2[i]))
-					overflow = true;
+		template <typename T, typename C1, typename C2, typename R> void finite_vector_multiply(const C1& v1, const C2& v2, R& result)
+		{
+			constexpr size_t n = limbs<C1>;
+
+			if ((const void*)&v1 == (const void*)&v2)
+				finite_vector_square<T>(v1, result);
+			else if constexpr (n >= short_product_threshold)
+			{
+				std::array<T, short_product_scratch(n)> scratch;
 
-			return overflow;
+				mulders<T>(v1.data(), v2.data(), n, result.data(), scratch.data());
+			}
+			else
+				mullo_basecase<T>(v1.data(), v2.data(), n, result.data());
 		}
 
-		template <typename C1, typename C2> bool finite_vector_add(C1& v1, const C2& v2)
+		//The operands are read after the result limbs are written, so the kernel runs from a copy of v1.
+		//
+		template <typename T, typename C1, typename C2> void finite_vector_multiply(C1& v1, const C2& v2)
 		{
-			bool overflow = false;
-
-			for (size_t i = 0; i < v1.size(); i++)
-				if (vad(v1, i, v2[i]))
-					overflow = true;
+			const C1 t = v1;
 
-			return overflow;
+			if ((const void*)&v1 == (const void*)&v2)
+				finite_vector_square<T>(t, v1);
+			else
+				finite_vector_multiply<T>(t, v2, v1);
 		}
 
 		template <typename C1, typename C2> bool finite_vector_greater(const C1& v1, const C2& v2)
@@ -407,11 +768,58 @@ namespace scalar_t
 		}
 
 
-		template <typename T> size_t greatest_bit(T t)
-		{
-			size_t r = 0;
+		constexpr size_t inverse_2adic_scratch(size_t n) { return 2 * n + short_product_scratch(n); }
 
-			while (t >>= 1)
+		/*
+			Newton / Hensel inverse modulo B^n of an odd a, x = a^-1 mod B^n.
+
+			a * a = 1 mod 8 for odd a, so x = a starts with 3 correct bits and x = x * ( 2 - a * x ) doubles them.
+			Above one limb, with x correct to k limbs, a * x = 1 + B^k * e and the update only touches limbs k..2k:
+
+			x = x - B^k * ( x * e mod B^k )
+
+			That is one short product of the new precision and one of the added half per step, no division.
+			scratch must hold inverse_2adic_scratch(n) limbs.
+		*/
+
+		//a^-1 mod B for an odd limb
+		//
+		template < typename T > T inverse_limb(T a)
+		{
+			T x = a;
+
+			for (size_t correct = 3; correct < bits<T>(); correct *= 2)
+				x = mul(x, T(T(2) - mul(a, x).second)).second;
+
+			return x;
+		}
+
+		template < typename T > void inverse_2adic(const T* a, size_t n, T* x, T* scratch)
+		{
+			std::fill(x, x + n - 1, T(0));
+			x[n - 1] = inverse_limb(a[n - 1]);
+
+			T* t = scratch, * f = scratch + n, * next = scratch + 2 * n;
+
+			for (size_t k = 1; k < n; k *= 2)
+			{
+				size_t m = (2 * k < n) ? 2 * k : n, h = m - k;
+
+				mulders(a + n - m, x + n - m, m, t, next);
+				mulders(x + n - h, t, h, f, next);
+
+				T* xh = x + n - m;
+
+				std::fill(xh, xh + h, T(0));
+				sub_n(xh, xh, f, h);
+			}
+		}
+
+		template <typename T> size_t greatest_bit(T t)
+		{
+			size_t r = 0;
+
+			while (t >>= 1)
 				r++;
 
 			return r;
@@ -433,70 +841,1158 @@ namespace scalar_t
 			return std::make_pair(quo, num);
 		}
 
-		template <typename T> auto finite_vector_div(const T& _num, const T& _den)
+		/*
+			2-by-1 division by a normalized ( top bit set ) divisor through its precomputed reciprocal, Moller & Granlund.
+
+			v = floor( (B^2 - 1) / d ) - B
+		*/
+
+		template < typename T > struct reciprocal_t
 		{
-			T num = _num, den = _den;
-			T quo;
+			T d, v;
+
+			reciprocal_t(T _d) : d(_d), v(intrinsic::udiv<T>(T(~_d), T(~T(0)), _d).first) {}
 
-			if (finite_vector_greater_equal(num, den))
+			//{ q, r } = ( u1 * B + u0 ) / d, requires u1 < d
+			//
+			std::pair<T, T> divide(T u1, T u0) const
 			{
-				size_t bits = num.Bits() - den.Bits();
+				auto [q1, q0] = mul(v, u1);
+
+				unsigned char c = intrinsic::addc<T>(0, q0, u0, q0);
+				intrinsic::addc<T>(c, q1, T(u1 + 1), q1);
 
-				den <<= bits;
+				T r = u0 - q1 * d;
 
-				for (; bits != -1; bits--)
+				if (r > q0)
 				{
-					if (finite_vector_greater_equal(num, den))
-					{
-						num -= den;
-						quo.SetBit(bits);
-					}
+					q1--;
+					r += d;
+				}
 
-					den >>= 1;
+				if (r >= d)
+				{
+					q1++;
+					r -= d;
 				}
+
+				return std::make_pair(q1, r);
 			}
+		};
 
-			return std::make_pair(quo, num);
+		//r = a << s across n limbs, returns the bits shifted out of a[0], 0 <= s < bits<T>()
+		//
+		template < typename T > T shl_n(T* r, const T* a, size_t n, size_t s)
+		{
+			if (!s)
+			{
+				std::copy(a, a + n, r);
+				return 0;
+			}
+
+			T out = a[0] >> (bits<T>() - s);
+
+			for (size_t i = 0; i < n - 1; i++)
+				r[i] = (a[i] << s) | (a[i + 1] >> (bits<T>() - s));
+
+			r[n - 1] = a[n - 1] << s;
+
+			return out;
+		}
+
+		//r = a >> s across n limbs, 0 <= s < bits<T>()
+		//
+		template < typename T > void shr_n(T* r, const T* a, size_t n, size_t s)
+		{
+			if (!n)
+				return;
+
+			if (!s)
+			{
+				std::copy(a, a + n, r);
+				return;
+			}
+
+			for (size_t i = n; --i > 0; )
+				r[i] = (a[i] >> s) | (a[i - 1] << (bits<T>() - s));
+
+			r[0] = a[0] >> s;
+		}
+
+		/*
+			Knuth Algorithm D, q = u / v and r = u % v on significant limbs ( most significant first ).
+
+			u has un limbs, v has vn >= 2 limbs with v[0] != 0 and un >= vn.
+			q receives un - vn + 1 limbs, r receives vn limbs.
+			w is scratch for un + 1 + vn limbs, the normalized copies of u and v.
+		*/
+
+		template < typename T > void divrem(const T* u, size_t un, const T* v, size_t vn, T* q, T* r, T* w)
+		{
+			size_t s = intrinsic::clz(v[0]);
+
+			T* nu = w, * nv = w + un + 1;
+
+			nu[0] = shl_n(nu + 1, u, un, s);
+			shl_n(nv, v, vn, s);
+
+			reciprocal_t<T> inv(nv[0]);
+			T d1 = nv[0], d0 = nv[1];
+
+			for (size_t j = 0; j <= un - vn; j++)
+			{
+				T* window = nu + j;
+				T qhat, rhat;
+				bool rhat_overflow = false;
+
+				if (window[0] == d1)
+				{
+					qhat = T(~T(0));
+					rhat_overflow = intrinsic::addc<T>(0, window[1], d1, rhat);
+				}
+				else
+					std::tie(qhat, rhat) = inv.divide(window[0], window[1]);
+
+				while (!rhat_overflow)
+				{
+					auto [h, l] = mul(qhat, d0);
+
+					if (h < rhat || (h == rhat && l <= window[2]))
+						break;
+
+					qhat--;
+					rhat_overflow = intrinsic::addc<T>(0, rhat, d1, rhat);
+				}
+
+				T carry = 0;
+				unsigned char borrow = 0;
+
+				for (size_t i = vn - 1; i != -1; i--)
+				{
+					auto [h, l] = mul(qhat, nv[i]);
+
+					h += intrinsic::addc<T>(0, l, carry, l);
+					carry = h;
+
+					borrow = intrinsic::subb<T>(borrow, window[i + 1], l, window[i + 1]);
+				}
+
+				borrow = intrinsic::subb<T>(borrow, window[0], carry, window[0]);
+
+				if (borrow)
+				{
+					qhat--;
+
+					unsigned char c = 0;
+
+					for (size_t i = vn - 1; i != -1; i--)
+						c = intrinsic::addc<T>(c, window[i + 1], nv[i], window[i + 1]);
+
+					window[0] += c;
+				}
+
+				q[j] = qhat;
+			}
+
+			shr_n(r, nu + un + 1 - vn, vn, s);
+		}
+
+		//Single limb divisor with its normalization shift and reciprocal, build once and reuse for a repeated d ( d != 0 ).
+		//
+		template < typename T > struct divisor_t
+		{
+			T d;
+			size_t s;
+			reciprocal_t<T> inv;
+
+			explicit divisor_t(T _d) : d(_d), s(intrinsic::clz(_d)), inv(T(_d << intrinsic::clz(_d))) {}
+		};
+
+		//q = u / d over un limbs, returns u % d. One 2-by-1 reciprocal step per limb, the shift is applied on the fly.
+		//
+		template < typename T > T divrem_1(const T* u, size_t un, const divisor_t<T>& d, T* q)
+		{
+			size_t s = d.s;
+			T r = s ? u[0] >> (bits<T>() - s) : 0;
+
+			for (size_t i = 0; i < un; i++)
+			{
+				T n = s ? (u[i] << s) | ((i + 1 < un) ? u[i + 1] >> (bits<T>() - s) : 0) : u[i];
+
+				std::tie(q[i], r) = d.inv.divide(r, n);
+			}
+
+			return r >> s;
+		}
+
+		//u % d without writing a quotient, for hashing into buckets and small prime sieving.
+		//
+		template < typename T > T mod_1(const T* u, size_t un, const divisor_t<T>& d)
+		{
+			size_t s = d.s;
+			T r = s ? u[0] >> (bits<T>() - s) : 0;
+
+			for (size_t i = 0; i < un; i++)
+			{
+				T n = s ? (u[i] << s) | ((i + 1 < un) ? u[i + 1] >> (bits<T>() - s) : 0) : u[i];
+
+				r = d.inv.divide(r, n).second;
+			}
+
+			return r >> s;
 		}
 
-		template<typename T> std::tuple<T, T, T> _e_gcd(const T & a, const T & b)
+		template <typename T> auto finite_vector_div(const T& num, const T& den)
 		{
-			if (a == 0)			
-				return std::make_tuple(b, 0, 1);		
+			using L = typename T::value_type;
+			constexpr size_t S = limbs<T>;
+
+			T quo{}, rem{};
 
-			T gcd, x, y;
+			size_t vi = 0, ui = 0;
 
-			auto [q,m] = b.Divide(a);
+			while (vi < S && !den[vi])
+				vi++;
 
-			auto [gcd, x, y] = _e_gcd<T>(m, a);
+			while (ui < S && !num[ui])
+				ui++;
 
-			return std::make_tuple(gcd, (y - q * x), x);
+			size_t vn = S - vi, un = S - ui;
+
+			if (!vn || un < vn || (un == vn && finite_vector_greater(den, num)))
+				return std::make_pair(quo, num);
+
+			if (vn == 1)
+			{
+				rem[S - 1] = divrem_1<L>(num.data() + ui, un, divisor_t<L>(den[S - 1]), quo.data() + ui);
+
+				return std::make_pair(quo, rem);
+			}
+
+			std::array<L, 2 * S + 1> scratch;
+
+			divrem<L>(num.data() + ui, un, den.data() + vi, vn, quo.data() + S - (un - vn + 1), rem.data() + vi, scratch.data());
+
+			return std::make_pair(quo, rem);
 		}
 
-		template<typename T> std::pair<T, T> _e_gcd_loop(T a, T b)
+		/*
+			floor( n^(1/k) ) by Newton's iteration on the reciprocal root, no division inside the loop.
+
+			n = A * 2^L with L a multiple of k and A in [2^-k, 1). Y = A^(-1/k) lies in (1, 2] and is refined by
+
+			Y = Y + Y * ( 1 - A * Y^k ) / k
+
+			in N = ( S + 1 ) limb fixed point, seeded from a double so each step doubles about 50 good bits.
+			Division by k is a product with a reciprocal formed once, for k = 2 it is a shift.
+			The root is A * Y^(k-1) * 2^(L/k), the truncation error is under one unit and is settled by the correction at the end.
+		*/
+
+		template <typename C> C iroot(const C& n, size_t k)
 		{
-			T aa[2] = { 1,0 }, bb[2] = { 0,1 },q;
+			using T = typename C::value_type;
+			constexpr size_t S = limbs<C>, b = bits<T>(), N = (S + 1) * b;
+
+			using X = std::array<T, S + 1>;
+			using W = std::array<T, 2 * S + 2>;
+
+			//the 0th root is undefined, it returns 0 like a division by zero
+			//
+			if (!k)
+				return C{};
+
+			size_t i = 0;
+
+			while (i < S && !n[i])
+				i++;
+
+			if (i == S || k == 1)
+				return n;
+
+			size_t nb = (S - 1 - i) * b + greatest_bit(n[i]) + 1;
+
+			C r{};
+
+			if (k >= nb)
+			{
+				r[S - 1] = 1;
+				return r;
+			}
+
+			//( x * y ) >> s, the result must fit X
+			//
+			auto mulshr = [](const X& x, const X& y, size_t s)
+			{
+				W w;
+				X t;
+
+				finite_vector_multiply_wide<T>(x, y, w);
+				vrs<T>(w, s);
+
+				std::copy(w.end() - (S + 1), w.end(), t.begin());
+
+				return t;
+			};
+
+			auto shifted = [](X x, int64_t s)
+			{
+				if (s > 0)
+					vls<T>(x, size_t(s));
+				else if (s < 0)
+					vrs<T>(x, size_t(-s));
+
+				return x;
+			};
+
+			size_t L = (nb + k - 1) / k * k;
+
+			X a{};
+			std::copy(n.begin(), n.end(), a.begin() + 1);
+			a = shifted(a, int64_t(N) - int64_t(L));
+
+			//log2( A ) from the leading 64 bits of a, the seed Y = 2^( -log2( A ) / k ) stays finite for any k
+			//
+			double m = 0;
+			size_t j = 0;
+
+			while (!a[j])
+				j++;
+
+			size_t top = std::min(j + (64 + b - 1) / b, S + 1);
+
+			for (size_t l = j; l < top; l++)
+				m = m * std::ldexp(1.0, int(b)) + double(a[l]);
+
+			double la = std::log2(m) + double(b * (S + 1 - top)) - double(N);
+
+			uint64_t seed = uint64_t(std::ldexp(std::exp2(-la / double(k)), 62));
+
+			if constexpr (N < 64)
+				seed >>= 64 - N;
+
+			X y{};
+
+			for (size_t l = S + 1; l-- > 0 && seed; )
+			{
+				y[l] = T(seed);
+				seed = (b < 64) ? seed >> (b % 64) : 0;
+			}
+
+			if constexpr (N > 64)
+				y = shifted(y, int64_t(N) - 64);
+
+			X ik{};
+
+			if (k != 2)
+			{
+				X ones, d{};
+				std::fill(ones.begin(), ones.end(), T(-1));
+
+				for (size_t l = S + 1, v = k; l-- > 0 && v; )
+				{
+					d[l] = T(v);
+					v = (b < 64) ? v >> (b % 64) : 0;
+				}
+
+				ik = finite_vector_div(ones, d).first;
+			}
+
+			X half{};
+			half[0] = T(1) << (b - 1);
+
+			for (size_t prec = 48; prec < L / k + 16; prec = 2 * prec - 4)
+			{
+				X p = a;
+				vrs<T>(p, 1);
+
+				for (size_t l = 0; l < k; l++)
+					p = mulshr(p, y, N - 2);
+
+				X e;
+				bool negative = finite_vector_subtract(half, p, e);
+
+				if (negative)
+					finite_vector_subtract(X{}, e, e);
+
+				X d = mulshr(y, e, N - 1);
+
+				if (k == 2)
+					vrs<T>(d, 1);
+				else
+					d = mulshr(d, ik, N);
+
+				if (negative)
+					finite_vector_subtract(y, d);
+				else
+					finite_vector_add(y, d);
+			}
+
+			X q = a;
+
+			for (size_t l = 1; l < k; l++)
+				q = mulshr(q, y, N - 2);
+
+			q = shifted(q, int64_t(L / k) - int64_t(N));
+
+			//r^k <= n, stopping as soon as a partial power passes n
+			//
+			auto fits = [&](const X& x)
+			{
+				X n1{}, p{};
+				std::copy(n.begin(), n.end(), n1.begin() + 1);
+
+				p[S] = 1;
+
+				for (size_t l = 0; l < k; l++)
+				{
+					W w;
+					finite_vector_multiply_wide<T>(p, x, w);
 
-			if (b > a)
-				std::swap(a, b);
+					if (std::any_of(w.begin(), w.begin() + S + 1, [](T v) { return v != 0; }))
+						return false;
 
-			while (true) 
+					std::copy(w.begin() + S + 1, w.end(), p.begin());
+
+					if (finite_vector_greater(p, n1))
+						return false;
+				}
+
+				return true;
+			};
+
+			X one{};
+			one[S] = 1;
+
+			while (!fits(q))
+				finite_vector_subtract(q, one);
+
+			for (X q1; finite_vector_add(q, one, q1), fits(q1); )
+				q = q1;
+
+			std::copy(q.begin() + 1, q.end(), r.begin());
+
+			return r;
+		}
+
+		//r = a * w over n limbs, returns the carry out of r[0]
+		//
+		template < typename T > T mul_1(T* r, const T* a, size_t n, T w)
+		{
+			T carry = 0;
+
+			for (size_t i = n - 1; i != -1; i--)
 			{
-				std::tie(q,a) = a.Divide(b);
+				auto [h, l] = mul(a[i], w);
+
+				h += intrinsic::addc<T>(0, l, carry, l);
+
+				r[i] = l;
+				carry = h;
+			}
+
+			return carry;
+		}
+
+		//c * x + d * y in the 2^n ring, |c| and |d| fit a single limb
+		//
+		template < typename U > U combine_1(const U& x, int64_t c, const U& y, int64_t d)
+		{
+			using T = typename U::value_type;
+
+			U r, t;
+
+			mul_1<T>(r.data(), x.data(), limbs<U>, T(c < 0 ? -c : c));
+			mul_1<T>(t.data(), y.data(), limbs<U>, T(d < 0 ? -d : d));
+
+			if (c < 0)
+				r = U(0) - r;
+
+			if (d < 0)
+				r -= t;
+			else
+				r += t;
+
+			return r;
+		}
+
+		/*
+			Lehmer extended GCD.
+
+			The leading h bits of A and the same bits of B are run through Euclid in machine words, collecting the
+			cofactor matrix ( a1 b1 / c1 d1 ) for as long as the quotients are certain ( Knuth Algorithm L ).
+			The matrix is then applied to the full values once, so most steps never touch more than one word.
+			When no quotient could be certified a single full Divide step is taken instead.
 
-				aa[0] = aa[0] - q * aa[1];  bb[0] = bb[0] - q * bb[1];
+			Returns { g, x, y } with a * x + b * y = g, x and y in two's complement.
+		*/
+
+		template < bool extended, typename U > std::tuple<U, U, U> lehmer_gcd(const U& a, const U& b)
+		{
+			using T = typename U::value_type;
+			constexpr size_t h = (bits<T>() < 62) ? bits<T>() : 62;
+
+			U A = a, B = b;
+			U xa = 1, ya = 0, xb = 0, yb = 1;
 
-				if (a == 0) 
-					return std::make_pair(aa[1], bb[1]);
+			if (finite_vector_greater(B, A))
+			{
+				std::swap(A, B);
+				std::swap(xa, xb);
+				std::swap(ya, yb);
+			}
 
-				std::tie(q, b) = b.Divide(a);
+			auto leading = [](const U& v, size_t shift)
+			{
+				U t = v >> shift;
+				uint64_t r = 0;
 
-				aa[1] = aa[1] - q * aa[0];  bb[1] = bb[1] - q * bb[0];
+				for (size_t i = 0; i * bits<T>() < 64 && i < limbs<U>; i++)
+					r |= uint64_t(t[limbs<U> - 1 - i]) << (i * bits<T>());
 
-				if (b == 0)
-					return std::make_pair(aa[0], bb[0]);
+				return int64_t(r);
 			};
 
+			while (B)
+			{
+				size_t length = A.Bits() + 1;
+				size_t shift = (length > h) ? length - h : 0;
+
+				int64_t ah = leading(A, shift), bh = leading(B, shift);
+				int64_t a1 = 1, b1 = 0, c1 = 0, d1 = 1;
+
+				if (!shift)
+				{
+					while (bh)
+					{
+						int64_t q = ah / bh, t;
+
+						t = ah - q * bh; ah = bh; bh = t;
+						t = a1 - q * c1; a1 = c1; c1 = t;
+						t = b1 - q * d1; b1 = d1; d1 = t;
+					}
+				}
+				else
+				{
+					while (bh + c1 != 0 && bh + d1 != 0)
+					{
+						int64_t q = (ah + a1) / (bh + c1);
+
+						if (q != (ah + b1) / (bh + d1))
+							break;
+
+						int64_t t;
+
+						t = ah - q * bh; ah = bh; bh = t;
+						t = a1 - q * c1; a1 = c1; c1 = t;
+						t = b1 - q * d1; b1 = d1; d1 = t;
+					}
+				}
+
+				if (!b1)
+				{
+					auto [q, r] = A.Divide(B);
+
+					A = B;
+					B = r;
+
+					if constexpr (extended)
+					{
+						U t;
+
+						t = xa - q * xb; xa = xb; xb = t;
+						t = ya - q * yb; ya = yb; yb = t;
+					}
+				}
+				else
+				{
+					U t = combine_1(A, a1, B, b1);
+					B = combine_1(A, c1, B, d1);
+					A = t;
+
+					if constexpr (extended)
+					{
+						t = combine_1(xa, a1, xb, b1);
+						xb = combine_1(xa, c1, xb, d1);
+						xa = t;
+
+						t = combine_1(ya, a1, yb, b1);
+						yb = combine_1(ya, c1, yb, d1);
+						ya = t;
+					}
+				}
+			}
+
+			return std::make_tuple(A, xa, ya);
+		}
+
+		//r += a * w over n limbs, returns the carry out of r[0]
+		//
+		template < typename T > T addmul_1(T* r, const T* a, size_t n, T w)
+		{
+#if defined(SCALAR_T_ADX)
+			if constexpr (std::is_same_v<T, uint64_t>)
+				if (intrinsic::bmi2_adx && n >= adx::threshold)
+					return adx::addmul_1(r, a, n, w);
+#endif
+
+			T carry = 0;
+
+			for (size_t i = n - 1; i != -1; i--)
+			{
+				auto [h, l] = mul(a[i], w);
+
+				h += intrinsic::addc<T>(0, l, carry, l);
+				h += intrinsic::addc<T>(0, r[i], l, r[i]);
+
+				carry = h;
+			}
+
+			return carry;
+		}
+
+		/*
+			Bernstein-Yang safegcd modular inverse.
+
+			Values are two's complement over n limbs, n leaves room for the 2^62 scaled products.
+			Every branch below depends only on the sizes, never on the values.
+		*/
+
+		namespace safegcd
+		{
+			constexpr uint64_t M62 = (uint64_t(1) << 62) - 1;
+
+			template < typename T > uint64_t mask(const T* a)
+			{
+				return uint64_t(0) - uint64_t(a[0] >> (bits<T>() - 1));
+			}
+
+			template < typename T > uint64_t low64(const T* a, size_t n)
+			{
+				uint64_t r = 0;
+
+				for (size_t i = 0; i * bits<T>() < 64 && i < n; i++)
+					r |= uint64_t(a[n - 1 - i]) << (i * bits<T>());
+
+				return r;
+			}
+
+			//a = ( a ^ mask ) - mask, negates a when mask is all ones
+			//
+			template < typename T > void cneg(T* a, size_t n, uint64_t m)
+			{
+				T tm = T(m);
+				unsigned char c = m & 1;
+
+				for (size_t i = n - 1; i != -1; i--)
+					c = intrinsic::addc<T>(c, T(a[i] ^ tm), T(0), a[i]);
+			}
+
+			//a += b & mask
+			//
+			template < typename T > void cadd(T* a, const T* b, size_t n, uint64_t m)
+			{
+				T tm = T(m);
+				unsigned char c = 0;
+
+				for (size_t i = n - 1; i != -1; i--)
+					c = intrinsic::addc<T>(c, a[i], T(b[i] & tm), a[i]);
+			}
+
+			//r += a * c for a signed 64 bit c
+			//
+			template < typename T > void addmul_s64(T* r, const T* a, size_t n, int64_t c, T* t)
+			{
+				uint64_t m = uint64_t(c >> 63);
+				uint64_t w = (uint64_t(c) ^ m) - m;
+
+				std::fill(t, t + n, T(0));
+
+				for (size_t j = 0; j * bits<T>() < 64 && j < n; j++)
+					addmul_1<T>(t, a + j, n - j, T(w >> (j * bits<T>())));
+
+				cneg(t, n, m);
+				add_n(r, r, t, n);
+			}
+
+			//arithmetic right shift by 62
+			//
+			template < typename T > void sar62(T* a, size_t n)
+			{
+				constexpr size_t q = 62 / bits<T>(), b = 62 % bits<T>();
+				T fill = T(mask(a));
+
+				if constexpr (q > 0)
+				{
+					for (size_t i = n - 1; i >= q; i--)
+						a[i] = a[i - q];
+
+					std::fill(a, a + q, fill);
+				}
+
+				if constexpr (b > 0)
+				{
+					for (size_t i = n - 1; i > 0; i--)
+						a[i] = T(a[i] >> b) | T(a[i - 1] << (bits<T>() - b));
+
+					a[0] = T(a[0] >> b) | T(fill << (bits<T>() - b));
+				}
+			}
+
+			struct matrix_t
+			{
+				int64_t u, v, q, r;
+			};
+
+			//62 branch free divsteps on the low words of f and g, returns the new delta. 2^62 * [ f g ] = t * [ f0 g0 ]
+			//
+			inline int64_t divsteps_62(int64_t delta, uint64_t f, uint64_t g, matrix_t& t)
+			{
+				uint64_t u = 1, v = 0, q = 0, r = 1;
+
+				for (size_t i = 0; i < 62; i++)
+				{
+					uint64_t c1 = uint64_t((-delta) >> 63);
+					uint64_t c2 = uint64_t(0) - (g & 1);
+
+					uint64_t x = (f ^ c1) - c1;
+					uint64_t y = (u ^ c1) - c1;
+					uint64_t z = (v ^ c1) - c1;
+
+					g += x & c2;
+					q += y & c2;
+					r += z & c2;
+
+					c1 &= c2;
+					delta = int64_t((uint64_t(delta) ^ c1) - c1) + 1;
+
+					f += g & c1;
+					u += q & c1;
+					v += r & c1;
+
+					g >>= 1;
+					u <<= 1;
+					v <<= 1;
+				}
+
+				t = { int64_t(u), int64_t(v), int64_t(q), int64_t(r) };
+
+				return delta;
+			}
+
+			//Divsteps needed for inputs of d bits, Bernstein & Yang theorem 11.2
+			//
+			constexpr size_t iterations(size_t d)
+			{
+				return (d < 46) ? (49 * d + 80) / 17 : (49 * d + 57) / 17;
+			}
+		}
+
+		/*
+			r = x^-1 mod m for an odd m, both S limbs. Returns false when gcd( x, m ) != 1, r is then 0.
+
+			f = m, g = x, d = 0, e = 1, invariants d * x = f and e * x = g ( mod m ).
+			Each round applies a 62 divstep transition matrix to f, g and to d, e, where multiples of m are added so the
+			division by 2^62 is exact and d, e stay inside ( -2m, m ).
+		*/
+
+		template < typename T, size_t S > bool safegcd_inverse(const T* x, const T* m, T* r)
+		{
+			using namespace safegcd;
+
+			constexpr size_t n = S + 2 * ((64 + bits<T>() - 1) / bits<T>());
+
+			std::array<T, n> f{}, g{}, d{}, e{}, mod{}, t1{}, t2{}, t{};
+
+			std::copy(m, m + S, f.data() + n - S);
+			std::copy(x, x + S, g.data() + n - S);
+			std::copy(m, m + S, mod.data() + n - S);
+			e[n - 1] = 1;
+
+			uint64_t minv = inverse_limb(low64(mod.data(), n));
+
+			int64_t delta = 1;
+
+			for (size_t i = 0; i < (iterations(S * bits<T>()) + 61) / 62; i++)
+			{
+				matrix_t mt;
+
+				delta = divsteps_62(delta, low64(f.data(), n), low64(g.data(), n), mt);
+
+				std::fill(t1.begin(), t1.end(), T(0));
+				std::fill(t2.begin(), t2.end(), T(0));
+
+				addmul_s64(t1.data(), f.data(), n, mt.u, t.data());
+				addmul_s64(t1.data(), g.data(), n, mt.v, t.data());
+				addmul_s64(t2.data(), f.data(), n, mt.q, t.data());
+				addmul_s64(t2.data(), g.data(), n, mt.r, t.data());
+
+				sar62(t1.data(), n);
+				sar62(t2.data(), n);
+
+				f = t1; g = t2;
+
+				uint64_t sd = mask(d.data()), se = mask(e.data());
+
+				int64_t cd = int64_t((uint64_t(mt.u) & sd) + (uint64_t(mt.v) & se));
+				int64_t ce = int64_t((uint64_t(mt.q) & sd) + (uint64_t(mt.r) & se));
+
+				std::fill(t1.begin(), t1.end(), T(0));
+				std::fill(t2.begin(), t2.end(), T(0));
+
+				addmul_s64(t1.data(), d.data(), n, mt.u, t.data());
+				addmul_s64(t1.data(), e.data(), n, mt.v, t.data());
+				addmul_s64(t2.data(), d.data(), n, mt.q, t.data());
+				addmul_s64(t2.data(), e.data(), n, mt.r, t.data());
+
+				cd -= int64_t((minv * low64(t1.data(), n) + uint64_t(cd)) & M62);
+				ce -= int64_t((minv * low64(t2.data(), n) + uint64_t(ce)) & M62);
+
+				addmul_s64(t1.data(), mod.data(), n, cd, t.data());
+				addmul_s64(t2.data(), mod.data(), n, ce, t.data());
+
+				sar62(t1.data(), n);
+				sar62(t2.data(), n);
+
+				d = t1; e = t2;
+			}
+
+			uint64_t sf = mask(f.data());
+
+			cadd(d.data(), mod.data(), n, mask(d.data()));
+			cneg(d.data(), n, sf);
+			cadd(d.data(), mod.data(), n, mask(d.data()));
+
+			cneg(f.data(), n, sf);
+
+			bool unit = f[n - 1] == 1 && std::all_of(f.begin(), f.end() - 1, [](T l) { return l == 0; });
+
+			if (unit)
+				std::copy(d.end() - S, d.end(), r);
+			else
+				std::fill(r, r + S, T(0));
+
+			return unit;
+		}
+
+		//Exponent window width for b bits, trades 2^(w-1) table entries against one multiply per w bits.
+		//
+		constexpr size_t window_bits(size_t b)
+		{
+			return (b > 671) ? 6 : (b > 239) ? 5 : (b > 79) ? 4 : (b > 23) ? 3 : 1;
+		}
+
+		//Table entries of the widest window, 2^5 odd powers for sliding windows of 6 bits and all 2^5 digits of the capped fixed window.
+		//
+		constexpr size_t window_table = size_t(1) << 5;
+
+		//Bits [i, i + w) of e, w < bits<T>()
+		//
+		template < typename C > size_t window(const C& e, size_t i, size_t w)
+		{
+			using T = typename C::value_type;
+			constexpr size_t n = limbs<C>, b = bits<T>();
+
+			size_t l = n - 1 - i / b, s = i % b;
+			size_t v = size_t(e[l] >> s);
+
+			if (s + w > b && l)
+				v |= size_t(e[l - 1]) << (b - s);
+
+			return v & ((size_t(1) << w) - 1);
+		}
+
+		/*
+			Left to right sliding window exponentiation over eb exponent bits.
+
+			Only odd powers x, x^3, ... x^(2^w - 1) are tabulated, runs of zero bits cost one square each
+			and every window starts and ends on a set bit.
+		*/
+
+		template < typename V, typename C, typename M, typename Q > V sliding_window_pow(const V& x, const C& e, size_t eb, const V& one, M mul, Q sqr)
+		{
+			if (!eb)
+				return one;
+
+			size_t w = window_bits(eb), count = size_t(1) << (w - 1);
+
+			std::array<V, window_table> table;
+
+			table[0] = x;
+
+			if (w > 1)
+			{
+				V x2 = sqr(x);
+
+				for (size_t i = 1; i < count; i++)
+					table[i] = mul(table[i - 1], x2);
+			}
+
+			V r = one;
+			bool started = false;
+
+			for (size_t i = eb; i-- > 0; )
+			{
+				if (!window(e, i, 1))
+				{
+					if (started)
+						r = sqr(r);
+
+					continue;
+				}
+
+				size_t l = (i + 1 > w) ? i + 1 - w : 0;
+
+				while (!window(e, l, 1))
+					l++;
+
+				size_t v = window(e, l, i - l + 1);
+
+				if (started)
+				{
+					for (size_t j = l; j <= i; j++)
+						r = sqr(r);
+
+					r = mul(r, table[v >> 1]);
+				}
+				else
+					r = table[v >> 1];
+
+				started = true;
+				i = l;
+			}
+
+			return r;
+		}
+
+		/*
+			Fixed window exponentiation that never branches on exponent bits.
+
+			Every window across the full width of e costs w squares and one multiply, the table entry is read by
+			scanning all 2^w entries under a mask so the access pattern does not depend on the window value.
+		*/
+
+		template < typename V, typename C, typename M, typename Q > V fixed_window_pow(const V& x, const C& e, const V& one, M mul, Q sqr)
+		{
+			using T = typename V::value_type;
+			constexpr size_t eb = limbs<C> * bits<typename C::value_type>();
+
+			constexpr size_t w = std::min<size_t>(window_bits(eb), 5);
+			static_assert((size_t(1) << w) <= window_table);
+
+			std::array<V, size_t(1) << w> table;
+
+			table[0] = one;
+
+			for (size_t i = 1; i < table.size(); i++)
+				table[i] = mul(table[i - 1], x);
+
+			V r = one;
+
+			for (size_t i = (eb + w - 1) / w * w; i > 0; )
+			{
+				i -= w;
+
+				for (size_t j = 0; j < w; j++)
+					r = sqr(r);
+
+				size_t v = window(e, i, w);
+				V t{};
+
+				for (size_t j = 0; j < table.size(); j++)
+				{
+					T m = T(0) - T(j == v);
+
+					for (size_t k = 0; k < t.size(); k++)
+						t[k] |= table[j][k] & m;
+				}
+
+				r = mul(r, t);
+			}
+
+			return r;
+		}
+
+		/*
+			Interleaved Straus multi-exponentiation, prod x[i] ^ e[i] over eb exponent bits.
+
+			Every base gets its own table of x^1 .. x^(2^w - 1) and all bases share one chain of eb squarings,
+			each w bit window then costs one multiply per base with a nonzero digit.
+		*/
+
+		template < typename V, typename C, typename M, typename Q > V straus_pow(const V* x, const C* e, size_t k, size_t eb, const V& one, M mul, Q sqr)
+		{
+			size_t w = 1;
+
+			for (size_t c = 2; c <= 6; c++)
+				if ((size_t(1) << c) + (eb + c - 1) / c < (size_t(1) << w) + (eb + w - 1) / w)
+					w = c;
+
+			size_t t = (size_t(1) << w) - 1;
+			std::vector<V> table(k * t);
+
+			for (size_t i = 0; i < k; i++)
+			{
+				table[i * t] = x[i];
+
+				for (size_t j = 1; j < t; j++)
+					table[i * t + j] = mul(table[i * t + j - 1], x[i]);
+			}
+
+			V r = one;
+			bool started = false;
+
+			for (size_t b = (eb + w - 1) / w * w; b > 0; )
+			{
+				b -= w;
+
+				if (started)
+					for (size_t j = 0; j < w; j++)
+						r = sqr(r);
+
+				for (size_t i = 0; i < k; i++)
+				{
+					size_t v = window(e[i], b, w);
+
+					if (!v)
+						continue;
+
+					r = started ? mul(r, table[i * t + v - 1]) : table[i * t + v - 1];
+					started = true;
+				}
+			}
+
+			return r;
+		}
+
+#ifndef SCALAR_T_PIPPENGER_THRESHOLD
+#define SCALAR_T_PIPPENGER_THRESHOLD 80
+#endif
+
+		//Base count at which multi-exponentiation switches from straus_pow() to pippenger_pow().
+		//
+		constexpr size_t pippenger_threshold = SCALAR_T_PIPPENGER_THRESHOLD;
+
+		/*
+			Pippenger bucket multi-exponentiation, prod x[i] ^ e[i] over eb exponent bits.
+
+			For each c bit window every base is multiplied into the bucket of its digit, then the running product
+			trick forms prod bucket[d] ^ d with two multiplies per bucket. c grows with log2 of the base count,
+			so the cost per base approaches eb / c multiplies.
+		*/
+
+		template < typename V, typename C, typename M, typename Q > V pippenger_pow(const V* x, const C* e, size_t k, size_t eb, const V& one, M mul, Q sqr)
+		{
+			size_t c = 1;
+
+			for (size_t d = 2; d <= 16 && d < bits<typename C::value_type>(); d++)
+				if ((eb + d - 1) / d * (k + (size_t(2) << d)) < (eb + c - 1) / c * (k + (size_t(2) << c)))
+					c = d;
+
+			std::vector<V> bucket(size_t(1) << c);
+			std::vector<bool> used(bucket.size());
+
+			V r = one;
+			bool started = false;
+
+			for (size_t b = (eb + c - 1) / c * c; b > 0; )
+			{
+				b -= c;
+
+				if (started)
+					for (size_t j = 0; j < c; j++)
+						r = sqr(r);
+
+				std::fill(used.begin(), used.end(), false);
+
+				for (size_t i = 0; i < k; i++)
+				{
+					size_t v = window(e[i], b, c);
+
+					if (!v)
+						continue;
+
+					bucket[v] = used[v] ? mul(bucket[v], x[i]) : x[i];
+					used[v] = true;
+				}
+
+				V running = one, sum = one;
+				bool have_running = false, have_sum = false;
+
+				for (size_t d = bucket.size() - 1; d > 0; d--)
+				{
+					if (used[d])
+					{
+						running = have_running ? mul(running, bucket[d]) : bucket[d];
+						have_running = true;
+					}
+
+					if (have_running)
+					{
+						sum = have_sum ? mul(sum, running) : running;
+						have_sum = true;
+					}
+				}
+
+				if (have_sum)
+				{
+					r = started ? mul(r, sum) : sum;
+					started = true;
+				}
+			}
+
+			return r;
+		}
+
+		/*
+			Montgomery's trick, every a[i] is replaced by its inverse with one call to inv for the whole batch.
+
+			skip( a[i] ) marks elements that are not invertible, they are set to 0 and left out of the chain.
+			When inv fails on the chain product, a is left as it was apart from the skipped elements, the product is
+			stored in p and false is returned so the caller can find the shared factor and run again with a tighter skip.
+			mul may carry a fixed scale, the unwind keeps the chain and the inverse at matching powers of it.
+		*/
+
+		template < typename V, typename M, typename I, typename K > bool batch_inverse(V* a, size_t n, M mul, I inv, K skip, V& p)
+		{
+			std::vector<V> prefix(n);
+			std::vector<size_t> live;
+
+			live.reserve(n);
+
+			for (size_t i = 0; i < n; i++)
+			{
+				if (skip(a[i]))
+				{
+					a[i] = V{};
+					continue;
+				}
+
+				prefix[live.size()] = live.empty() ? a[i] : mul(prefix[live.size() - 1], a[i]);
+				live.push_back(i);
+			}
+
+			if (live.empty())
+				return true;
+
+			V z;
+
+			p = prefix[live.size() - 1];
+
+			if (!inv(p, z))
+				return false;
+
+			for (size_t j = live.size() - 1; j > 0; j--)
+			{
+				V& x = a[live[j]];
+				V t = mul(z, prefix[j - 1]);
+
+				z = mul(z, x);
+				x = t;
+			}
+
+			a[live[0]] = z;
+
+			return true;
 		}
 	}
-}
\ No newline at end of file
+}
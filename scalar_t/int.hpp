@@ -6,6 +6,8 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <span>
+#include <ranges>
 
 #include <cstdint>
 #include <type_traits>
@@ -59,27 +61,87 @@ namespace scalar_t
 				e = ~e;
 		}
 
-		U MultiplicativeInverse()
+		//Inverse modulo 2^n. Only odd values are invertible, even values return 0.
+		//
+		U MultiplicativeInverse() const
 		{
-			EX c, t;
+			U r;
+
+			if (!(B::back() & 1))
+				return r;
 
-			t[0] = 1;
-			std::copy(B::begin(), B::end(), &c[1]);
+			std::array<T, inverse_2adic_scratch(S)> scratch;
 
-			auto [x, y] = _e_gcd_loop(c,t);
+			inverse_2adic<T>(B::data(), S, r.data(), scratch.data());
+
+			return r;
+		}
 
+		//Inverse modulo an odd m > 1 by safegcd divsteps, 0 when m is even or gcd( *this, m ) != 1.
+		//
+		U ModInverse(const U& m) const
+		{
 			U r;
-			std::copy(y.begin()+1, y.end(), &r[0]);
 
-			if (*this * r == 1)
-				return r;
+			if ((m.back() & 1) && m != 1)
+				safegcd_inverse<T, S>(B::data(), m.data(), r.data());
 
-			r = U(0) - r;
+			return r;
+		}
 
-			if (*this * r == 1)
-				return r;
+		U Gcd(const U& r) const
+		{
+			return std::get<0>(lehmer_gcd<false>(*this, r));
+		}
 
-			return U(1);
+		//{ g, x, y } with *this * x + r * y == g, the cofactors are two's complement.
+		//
+		std::tuple<U, U, U> ExtendedGcd(const U& r) const
+		{
+			return lehmer_gcd<true>(*this, r);
+		}
+
+		//floor( sqrt( *this ) )
+		//
+		U ISqrt() const
+		{
+			return iroot(*this, 2);
+		}
+
+		//floor( *this ^ ( 1 / k ) ), 0 for k = 0
+		//
+		U IRoot(size_t k) const
+		{
+			return iroot(*this, k);
+		}
+
+		//*this ^ e modulo 2^n. constant_time runs a fixed window over every bit of e instead of a sliding window over e.Bits().
+		//
+		template < bool constant_time = false > U Pow(const U& e) const
+		{
+			auto mul = [](const U& a, const U& b) { return a * b; };
+			auto sqr = [](const U& a) { return a.Square(); };
+
+			if constexpr (constant_time)
+				return fixed_window_pow(*this, e, U(1), mul, sqr);
+			else
+				return sliding_window_pow(*this, e, e ? e.Bits() + 1 : 0, U(1), mul, sqr);
+		}
+
+		//*this ^ e modulo ctx.Modulus() through Montgomery form, ctx is a MontgomeryContext<U>.
+		//constant_time adds no branch or division on *this or e, ToMontgomery reduces any *this < R by itself.
+		//
+		template < bool constant_time = false, typename C > U ModPow(const U& e, const C& ctx) const
+		{
+			auto mul = [&](const U& a, const U& b) { return ctx.Multiply(a, b); };
+			auto sqr = [&](const U& a) { return ctx.Square(a); };
+
+			U x = ctx.ToMontgomery(*this);
+
+			if constexpr (constant_time)
+				return ctx.FromMontgomery(fixed_window_pow(x, e, ctx.One(), mul, sqr));
+			else
+				return ctx.FromMontgomery(sliding_window_pow(x, e, e ? e.Bits() + 1 : 0, ctx.One(), mul, sqr));
 		}
 
 		uintv_t() : B{} {}
@@ -136,6 +198,22 @@ namespace scalar_t
 			return result;
 		}
 
+		U Square() const
+		{
+			U result;
+
+			finite_vector_square<T>(*this, result);
+
+			return result;
+		}
+
+		U& SquareInPlace()
+		{
+			finite_vector_square<T>(*this);
+
+			return *this;
+		}
+
 		U& operator++()
 		{
 			vad(*this, B::size() - 1, 1);
@@ -219,7 +297,28 @@ namespace scalar_t
 
 		T operator% (T m) const
 		{
-			return B::back() % m;
+			if (!(m & (m - 1)))
+				return B::back() & (m - 1);
+
+			return mod_1<T>(B::data(), S, divisor_t<T>(m));
+		}
+
+		T operator% (const divisor_t<T>& m) const
+		{
+			return mod_1<T>(B::data(), S, m);
+		}
+
+		std::pair<U, T> DivRem(T d) const
+		{
+			return DivRem(divisor_t<T>(d));
+		}
+
+		std::pair<U, T> DivRem(const divisor_t<T>& d) const
+		{
+			U q;
+			T r = divrem_1<T>(B::data(), S, d, q.data());
+
+			return std::make_pair(q, r);
 		}
 
 		U operator << (size_t b) const
@@ -291,7 +390,10 @@ namespace scalar_t
 
 		void FMADD(const U& t1, const U& t2)
 		{
-			finite_vector_fuse_multiply_add(t1, t2, *this);
+			if constexpr (S >= short_product_threshold)
+				*this += t1 * t2;
+			else
+				finite_vector_fuse_multiply_add(t1, t2, *this);
 		}
 
 		void FM3IAD_basic(const U& t1, const U& t2, const U& t3)
@@ -306,7 +408,10 @@ namespace scalar_t
 
 		void FM2IAD(const U& t1, const U& t2)
 		{
-			finite_vector_fuse_multiply2_invadd<T>(t1, t2, *this);
+			if constexpr (S >= short_product_threshold)
+				*this -= t1 * t2;
+			else
+				finite_vector_fuse_multiply2_invadd<T>(t1, t2, *this);
 		}
 
 		void INVADD(const U& t1)
@@ -314,4 +419,70 @@ namespace scalar_t
 			finite_vector_inverse_add<T>(*this, t1);
 		}
 	};
+
+	template<typename T, size_t S> uintv_t<T, 2 * S> MulWide(const uintv_t<T, S>& a, const uintv_t<T, S>& b)
+	{
+		uintv_t<T, 2 * S> result;
+
+		finite_vector_multiply_wide<T>(a, b, result);
+
+		return result;
+	}
+
+	//Writable uintv_t elements, the range overloads below accept nothing else.
+	//
+	template < typename V > constexpr bool is_uintv = false;
+	template < typename T, size_t S > constexpr bool is_uintv<uintv_t<T, S>> = true;
+
+	//Inverts every element of a contiguous range of uintv_t ( vector, array, span ) modulo 2^n, even elements are set to 0 and their count is returned.
+	//The 2-adic Newton inverse costs less than the three products per element of a prefix chain at every size, so each element is inverted directly.
+	//
+	template < typename C > requires std::ranges::contiguous_range<C> && is_uintv<std::remove_reference_t<std::ranges::range_reference_t<C>>>
+	size_t BatchInverse(C&& values)
+	{
+		size_t even = 0;
+
+		for (auto& v : values)
+		{
+			even += !(v.back() & 1);
+			v = v.MultiplicativeInverse();
+		}
+
+		return even;
+	}
+
+	//prod bases[i] ^ exps[i] modulo ctx.Modulus() with one shared squaring chain, ctx is a MontgomeryContext.
+	//
+	template<typename U, typename C> U MultiModPow(const std::vector<U>& bases, const std::vector<U>& exps, const C& ctx)
+	{
+		size_t k = std::min(bases.size(), exps.size()), eb = 0;
+
+		std::vector<U> x(k);
+
+		for (size_t i = 0; i < k; i++)
+		{
+			x[i] = ctx.ToMontgomery(bases[i] % ctx.Modulus());
+
+			if (exps[i])
+				eb = std::max(eb, exps[i].Bits() + 1);
+		}
+
+		auto mul = [&](const U& a, const U& b) { return ctx.Multiply(a, b); };
+		auto sqr = [&](const U& a) { return ctx.Square(a); };
+
+		if (k < pippenger_threshold)
+			return ctx.FromMontgomery(straus_pow(x.data(), exps.data(), k, eb, ctx.One(), mul, sqr));
+		else
+			return ctx.FromMontgomery(pippenger_pow(x.data(), exps.data(), k, eb, ctx.One(), mul, sqr));
+	}
+
+	template<typename T, size_t S> uintv_t<T, S> MulHigh(const uintv_t<T, S>& a, const uintv_t<T, S>& b)
+	{
+		auto wide = MulWide(a, b);
+
+		uintv_t<T, S> result;
+		std::copy(wide.begin(), wide.begin() + S, result.begin());
+
+		return result;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,232 @@
+/* Copyright (C) 2020 D8DATAWORKS - All Rights Reserved */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+
+/*
+	Compiler backend for the limb primitives.
+
+	MSVC x64:		_umul128, _udiv128, _addcarry_u64, _subborrow_u64 from <intrin.h>
+	GCC / Clang:	unsigned __int128 for the wide multiply, divq for the 2-by-1 divide on x86-64,
+					__builtin_addcll / __builtin_subcll when available,
+					otherwise _addcarry_u64 / _subborrow_u64 from <x86intrin.h>
+	Anything else:	portable half word code.
+
+	Every routine here is endian neutral, the high word is taken by shifting, never through a union.
+*/
+
+#if defined(_MSC_VER) && !defined(__clang__)
+	#include <intrin.h>
+	#if defined(_M_X64)
+		#pragma intrinsic(_umul128)
+		#pragma intrinsic(_udiv128)
+		#pragma intrinsic(_addcarry_u64)
+		#pragma intrinsic(_subborrow_u64)
+		#pragma intrinsic(_BitScanReverse64)
+		#define SCALAR_T_MSVC_X64
+	#endif
+#elif defined(__x86_64__)
+	#include <x86intrin.h>
+	#define SCALAR_T_X86INTRIN
+#endif
+
+#if defined(__SIZEOF_INT128__)
+	#define SCALAR_T_INT128
+#endif
+
+#if defined(__has_builtin)
+	#if __has_builtin(__builtin_addcll) && __has_builtin(__builtin_subcll)
+		#define SCALAR_T_BUILTIN_ADDC
+	#endif
+#endif
+
+namespace scalar_t
+{
+	namespace intrinsic
+	{
+		template < typename T > struct wide {};
+		template <> struct wide<uint8_t> { using type = uint16_t; };
+		template <> struct wide<uint16_t> { using type = uint32_t; };
+		template <> struct wide<uint32_t> { using type = uint64_t; };
+
+		template < typename T > using wide_t = typename wide<T>::type;
+
+		//Returns { high, low }
+		//
+		template < typename T > std::pair<T, T> umul(T a, T b)
+		{
+			static_assert(std::is_unsigned<T>(), "limbs must be unsigned");
+
+			if constexpr (sizeof(T) < sizeof(uint64_t))
+			{
+				auto l = (wide_t<T>)a * (wide_t<T>)b;
+
+				return std::make_pair(T(l >> (sizeof(T) * 8)), T(l));
+			}
+			else
+			{
+#if defined(SCALAR_T_INT128)
+				auto l = (unsigned __int128)a * b;
+
+				return std::make_pair(T(l >> 64), T(l));
+#elif defined(SCALAR_T_MSVC_X64)
+				unsigned __int64 h;
+				T l = _umul128(a, b, &h);
+
+				return std::make_pair(T(h), l);
+#else
+				uint64_t a0 = (uint32_t)a, a1 = a >> 32;
+				uint64_t b0 = (uint32_t)b, b1 = b >> 32;
+
+				uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+				uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+
+				return std::make_pair(T(p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32)), T((mid << 32) | (uint32_t)p00));
+#endif
+			}
+		}
+
+		//out = a + b + carry, returns the carry out
+		//
+		template < typename T > unsigned char addc(unsigned char carry, T a, T b, T& out)
+		{
+			if constexpr (sizeof(T) < sizeof(uint64_t))
+			{
+				auto l = (wide_t<T>)a + (wide_t<T>)b + carry;
+				out = T(l);
+
+				return (unsigned char)(l >> (sizeof(T) * 8));
+			}
+			else
+			{
+#if defined(SCALAR_T_BUILTIN_ADDC)
+				unsigned long long c;
+				out = T(__builtin_addcll(a, b, carry, &c));
+
+				return (unsigned char)c;
+#elif defined(SCALAR_T_X86INTRIN) || defined(SCALAR_T_MSVC_X64)
+				unsigned long long r;
+				carry = _addcarry_u64(carry, a, b, &r);
+				out = T(r);
+
+				return carry;
+#else
+				T s = a + b;
+				unsigned char c = s < a;
+				out = s + carry;
+
+				return c | (out < s);
+#endif
+			}
+		}
+
+		//out = a - b - borrow, returns the borrow out
+		//
+		template < typename T > unsigned char subb(unsigned char borrow, T a, T b, T& out)
+		{
+			if constexpr (sizeof(T) < sizeof(uint64_t))
+			{
+				auto l = (wide_t<T>)a - (wide_t<T>)b - borrow;
+				out = T(l);
+
+				return (unsigned char)((l >> (sizeof(T) * 8)) & 1);
+			}
+			else
+			{
+#if defined(SCALAR_T_BUILTIN_ADDC)
+				unsigned long long c;
+				out = T(__builtin_subcll(a, b, borrow, &c));
+
+				return (unsigned char)c;
+#elif defined(SCALAR_T_X86INTRIN) || defined(SCALAR_T_MSVC_X64)
+				unsigned long long r;
+				borrow = _subborrow_u64(borrow, a, b, &r);
+				out = T(r);
+
+				return borrow;
+#else
+				T d = a - b;
+				unsigned char c = a < b;
+				out = d - borrow;
+
+				return c | (d < out);
+#endif
+			}
+		}
+
+		//Hardware 2-by-1 divide, { q, r } = ( hi * B + lo ) / d, requires hi < d.
+		//
+		template < typename T > std::pair<T, T> udiv(T hi, T lo, T d)
+		{
+			if constexpr (sizeof(T) < sizeof(uint64_t))
+			{
+				auto n = ((wide_t<T>)hi << (sizeof(T) * 8)) | lo;
+
+				return std::make_pair(T(n / d), T(n % d));
+			}
+			else
+			{
+#if defined(SCALAR_T_X86INTRIN)
+				uint64_t q, r;
+				__asm__("divq %4" : "=a"(q), "=d"(r) : "a"(uint64_t(lo)), "d"(uint64_t(hi)), "rm"(uint64_t(d)));
+
+				return std::make_pair(T(q), T(r));
+#elif defined(SCALAR_T_MSVC_X64)
+				unsigned __int64 r;
+				T q = _udiv128(hi, lo, d, &r);
+
+				return std::make_pair(q, T(r));
+#elif defined(SCALAR_T_INT128)
+				auto n = ((unsigned __int128)hi << 64) | lo;
+
+				return std::make_pair(T(n / d), T(n % d));
+#else
+				T q = 0;
+
+				for (size_t i = 0; i < 64; i++)
+				{
+					bool top = hi >> 63;
+
+					hi = (hi << 1) | (lo >> 63);
+					lo <<= 1;
+					q <<= 1;
+
+					if (top || hi >= d)
+					{
+						hi -= d;
+						q |= 1;
+					}
+				}
+
+				return std::make_pair(q, hi);
+#endif
+			}
+		}
+
+		//Count of leading zero bits, t must not be zero.
+		//
+		template < typename T > size_t clz(T t)
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+	#if defined(SCALAR_T_MSVC_X64)
+			unsigned long i;
+			_BitScanReverse64(&i, t);
+
+			return sizeof(T) * 8 - 1 - i;
+	#else
+			size_t n = 0;
+
+			for (T m = T(1) << (sizeof(T) * 8 - 1); !(t & m); m >>= 1)
+				n++;
+
+			return n;
+	#endif
+#else
+			return __builtin_clzll(t) - (64 - sizeof(T) * 8);
+#endif
+		}
+	}
+}
@@ -0,0 +1,317 @@
+/* Copyright (C) 2020 D8DATAWORKS - All Rights Reserved */
+
+#pragma once
+
+#include <array>
+#include <span>
+#include <type_traits>
+
+#include "int.hpp"
+
+namespace scalar_t
+{
+	/*
+		Montgomery arithmetic modulo an odd n, R = B^S.
+
+		Values in Montgomery form are a * R mod n and stay below n.
+		Multiply is interleaved CIOS ( coarsely integrated operand scanning ), Square forms the full square with the
+		dedicated kernel and then runs the reduction on its own.
+	*/
+
+	template < typename U > class MontgomeryContext
+	{
+		using T = typename U::value_type;
+		static constexpr size_t S = helper::limbs<U>;
+
+		using W = uintv_t<T, 2 * S>;
+
+		U n;
+		U r2;
+		U one;
+		T ninv;
+
+		//r or d = r - n under a mask, no branch on the values
+		//
+		static U Select(U& r, const U& d, bool take)
+		{
+			T m = T(0) - T(take);
+
+			for (size_t i = 0; i < S; i++)
+				r[i] ^= (r[i] ^ d[i]) & m;
+
+			return r;
+		}
+
+		//t = t - n when t[S] is set or t >= n, t is least significant limb first with S + 1 limbs
+		//
+		U Final(const std::array<T, S + 2>& t) const
+		{
+			U r, d;
+
+			for (size_t i = 0; i < S; i++)
+				r[S - 1 - i] = t[i];
+
+			bool borrow = helper::finite_vector_subtract(r, n, d);
+
+			return Select(r, d, (t[S] != 0) | !borrow);
+		}
+
+#if defined(SCALAR_T_ADX)
+		//Row form of Multiply and Reduce for the BMI2 / ADX kernels, t is most significant limb first and each row is one addmul_1.
+		//A row starts at limb lo and carries into lo - S. Multiply keeps t[lo - S - 1 .. lo] below ( a + n ) * B, so the carry stops at lo - S - 1.
+		//
+		void AddRow(T* t, size_t lo, const T* x, T w) const
+		{
+			T c = helper::addmul_1<T>(t + lo - S + 1, x, S, w);
+
+			t[lo - S - 1] += intrinsic::addc<T>(0, t[lo - S], c, t[lo - S]);
+		}
+
+		//t[1 .. S] reduced below n, t[0] holds the overflow limb
+		//
+		U FinalRows(const T* t) const
+		{
+			U r, d;
+			std::copy(t + 1, t + S + 1, r.begin());
+
+			bool borrow = helper::finite_vector_subtract(r, n, d);
+
+			return Select(r, d, (t[0] != 0) | !borrow);
+		}
+
+		U MultiplyRows(const U& a, const U& b) const
+		{
+			std::array<T, 2 * S + 1> t{};
+
+			for (size_t i = 0, lo = 2 * S; i < S; i++, lo--)
+			{
+				AddRow(t.data(), lo, a.data(), b[S - 1 - i]);
+				AddRow(t.data(), lo, n.data(), T(t[lo] * ninv));
+			}
+
+			return FinalRows(t.data());
+		}
+
+		//The upper half of a is live, so row carries are kept apart and added in one pass. No row reads the limbs they land on.
+		//
+		U ReduceRows(const W& a) const
+		{
+			std::array<T, 2 * S + 1> t;
+			std::array<T, S + 1> c{};
+
+			t[0] = 0;
+			std::copy(a.begin(), a.end(), t.begin() + 1);
+
+			for (size_t i = 0, lo = 2 * S; i < S; i++, lo--)
+				c[lo - S] = helper::addmul_1<T>(t.data() + lo - S + 1, n.data(), S, T(t[lo] * ninv));
+
+			t[0] = helper::add_n<T>(t.data() + 1, t.data() + 1, c.data() + 1, S);
+
+			return FinalRows(t.data());
+		}
+#endif
+
+	public:
+
+		MontgomeryContext(const U& modulus) : n(modulus)
+		{
+			ninv = T(0) - helper::inverse_limb(n.back());
+
+			uintv_t<T, S + 1> b, wn;
+			uintv_t<T, 2 * S + 1> b2, w2n;
+
+			b[0] = 1;
+			b2[0] = 1;
+
+			std::copy(n.begin(), n.end(), wn.begin() + 1);
+			std::copy(n.begin(), n.end(), w2n.begin() + S + 1);
+
+			auto m1 = b % wn;
+			auto m2 = b2 % w2n;
+
+			std::copy(m1.begin() + 1, m1.end(), one.begin());
+			std::copy(m2.begin() + S + 1, m2.end(), r2.begin());
+		}
+
+		const U& Modulus() const { return n; }
+
+		//R mod n, the Montgomery form of 1
+		//
+		const U& One() const { return one; }
+
+		//a * R mod n for any a, a * r2 < n * R since r2 < n
+		//
+		U ToMontgomery(const U& a) const
+		{
+			return Multiply(a, r2);
+		}
+
+		U FromMontgomery(const U& a) const
+		{
+			return Multiply(a, U(1));
+		}
+
+		//a * b * R^-1 mod n, requires a * b < n * R
+		//
+		U Multiply(const U& a, const U& b) const
+		{
+#if defined(SCALAR_T_ADX)
+			if constexpr (std::is_same_v<T, uint64_t> && S >= helper::adx::threshold)
+				if (intrinsic::bmi2_adx)
+					return MultiplyRows(a, b);
+#endif
+
+			std::array<T, S + 2> t{};
+
+			for (size_t i = 0; i < S; i++)
+			{
+				T bi = b[S - 1 - i], c = 0;
+
+				for (size_t j = 0; j < S; j++)
+				{
+					auto [h, l] = helper::mul(a[S - 1 - j], bi);
+
+					h += intrinsic::addc<T>(0, l, t[j], l);
+					h += intrinsic::addc<T>(0, l, c, l);
+
+					t[j] = l;
+					c = h;
+				}
+
+				t[S + 1] = intrinsic::addc<T>(0, t[S], c, t[S]);
+
+				T m = helper::mul(t[0], ninv).second;
+
+				auto [h0, l0] = helper::mul(m, n[S - 1]);
+				c = h0 + intrinsic::addc<T>(0, l0, t[0], l0);
+
+				for (size_t j = 1; j < S; j++)
+				{
+					auto [h, l] = helper::mul(m, n[S - 1 - j]);
+
+					h += intrinsic::addc<T>(0, l, t[j], l);
+					h += intrinsic::addc<T>(0, l, c, l);
+
+					t[j - 1] = l;
+					c = h;
+				}
+
+				unsigned char carry = intrinsic::addc<T>(0, t[S], c, t[S - 1]);
+				t[S] = t[S + 1] + carry;
+			}
+
+			return Final(t);
+		}
+
+		//a * R^-1 mod n for a double width a < n * R
+		//
+		U Reduce(const W& a) const
+		{
+#if defined(SCALAR_T_ADX)
+			if constexpr (std::is_same_v<T, uint64_t> && S >= helper::adx::threshold)
+				if (intrinsic::bmi2_adx)
+					return ReduceRows(a);
+#endif
+
+			std::array<T, 2 * S + 1> t{};
+			std::array<T, S> cy;
+
+			for (size_t i = 0; i < 2 * S; i++)
+				t[i] = a[2 * S - 1 - i];
+
+			for (size_t i = 0; i < S; i++)
+			{
+				T m = helper::mul(t[i], ninv).second, c = 0;
+
+				for (size_t j = 0; j < S; j++)
+				{
+					auto [h, l] = helper::mul(m, n[S - 1 - j]);
+
+					h += intrinsic::addc<T>(0, l, t[i + j], l);
+					h += intrinsic::addc<T>(0, l, c, l);
+
+					t[i + j] = l;
+					c = h;
+				}
+
+				cy[i] = c;
+			}
+
+			//row i carries into t[i + S], which no later row reads, so the carries are added once at the end
+			//
+			unsigned char carry = 0;
+
+			for (size_t i = 0; i < S; i++)
+				carry = intrinsic::addc<T>(carry, t[S + i], cy[i], t[S + i]);
+
+			t[2 * S] = carry;
+
+			std::array<T, S + 2> r{};
+			std::copy(t.begin() + S, t.end(), r.begin());
+
+			return Final(r);
+		}
+
+		U Square(const U& a) const
+		{
+			W w;
+
+			helper::sqr_basecase<T>(a.data(), S, w.data(), 2 * S);
+
+			return Reduce(w);
+		}
+
+		U Add(const U& a, const U& b) const
+		{
+			U s, d;
+
+			bool carry = helper::finite_vector_add(a, b, s);
+			bool borrow = helper::finite_vector_subtract(s, n, d);
+
+			return (carry || !borrow) ? d : s;
+		}
+
+		U Sub(const U& a, const U& b) const
+		{
+			U d;
+
+			if (helper::finite_vector_subtract(a, b, d))
+				helper::finite_vector_add(d, n);
+
+			return d;
+		}
+	};
+
+	/*
+		Inverts every element modulo ctx.Modulus() with one ModInverse for the batch, elements are reduced first when needed.
+		Elements sharing a factor with the modulus are set to 0, their count is returned.
+
+		The chain runs on plain values with Montgomery products, so it carries powers of R^-1. The inverse of the
+		chain carries the matching powers of R and each unwind step cancels one of them, 3 products per element.
+		A composite modulus can make the chain fail, g = gcd( chain, m ) then holds every prime of m that divides
+		an element, so a second pass that skips the elements sharing a factor with g always succeeds.
+	*/
+
+	template < typename U > size_t BatchInverse(std::type_identity_t<std::span<U>> values, const MontgomeryContext<U>& ctx)
+	{
+		const U& m = ctx.Modulus();
+
+		for (auto& v : values)
+			if (helper::finite_vector_greater_equal(v, m))
+				v = v % m;
+
+		auto mul = [&](const U& a, const U& b) { return ctx.Multiply(a, b); };
+		auto inv = [&](const U& a, U& r) { r = a.ModInverse(m); return bool(r); };
+
+		U p;
+
+		if (!helper::batch_inverse(values.data(), values.size(), mul, inv, [](const U& a) { return !a; }, p))
+		{
+			U g = p.Gcd(m);
+
+			helper::batch_inverse(values.data(), values.size(), mul, inv, [&](const U& a) { return !a || a.Gcd(g) != 1; }, p);
+		}
+
+		return std::count_if(values.begin(), values.end(), [](const U& a) { return !a; });
+	}
+}
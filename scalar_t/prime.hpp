@@ -0,0 +1,644 @@
+/* Copyright (C) 2020 D8DATAWORKS - All Rights Reserved */
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <limits>
+#include <optional>
+
+#include "montgomery.hpp"
+
+namespace scalar_t
+{
+	namespace helper
+	{
+		namespace prime
+		{
+			//Odd primes below 1000 for trial division, every composite without a factor in the table is at least 1009^2.
+			//
+			constexpr size_t small_prime_count = 167;
+			constexpr uint64_t small_prime_square = 1009 * 1009;
+
+			constexpr std::array<uint16_t, small_prime_count> small_primes = []()
+			{
+				std::array<uint16_t, small_prime_count> r{};
+				std::array<bool, 1000> composite{};
+
+				size_t k = 0;
+
+				for (size_t i = 3; i < 1000; i += 2)
+				{
+					if (composite[i])
+						continue;
+
+					r[k++] = uint16_t(i);
+
+					for (size_t j = i * i; j < 1000; j += 2 * i)
+						composite[j] = true;
+				}
+
+				return r;
+			}();
+
+			//n mod a for a < 2^32, through the single limb reciprocal for 64 bit limbs and a two limb Horner step otherwise
+			//
+			template < typename U > uint64_t mod_small(const U& n, uint64_t a)
+			{
+				using T = typename U::value_type;
+
+				if constexpr (sizeof(T) == sizeof(uint64_t))
+					return mod_1<T>(n.data(), limbs<U>, divisor_t<T>(a));
+				else
+				{
+					uint64_t r = 0;
+
+					for (auto e : n)
+						r = ((r << bits<T>()) | e) % a;
+
+					return r;
+				}
+			}
+
+			//Products of consecutive table primes that fit below 2^32, with the table range each one covers
+			//
+			struct group_t
+			{
+				uint64_t product;
+				size_t first, last;
+			};
+
+			inline const std::vector<group_t>& groups()
+			{
+				static const std::vector<group_t> g = []()
+				{
+					std::vector<group_t> r;
+
+					for (size_t i = 0; i < small_prime_count; )
+					{
+						group_t t{ 1, i, i };
+
+						while (t.last < small_prime_count && t.product * small_primes[t.last] < (uint64_t(1) << 32))
+							t.product *= small_primes[t.last++];
+
+						r.push_back(t);
+						i = t.last;
+					}
+
+					return r;
+				}();
+
+				return g;
+			}
+
+			//false when a table prime divides n, n itself must be above the table
+			//
+			template < typename U > bool trial_division(const U& n)
+			{
+				if (!(n.back() & 1))
+					return false;
+
+				for (auto& g : groups())
+				{
+					uint64_t r = mod_small(n, g.product);
+
+					for (size_t i = g.first; i < g.last; i++)
+						if (r % small_primes[i] == 0)
+							return false;
+				}
+
+				return true;
+			}
+
+			//Jacobi symbol ( a / n ) for odd n
+			//
+			inline int jacobi(uint64_t a, uint64_t n)
+			{
+				int t = 1;
+
+				a %= n;
+
+				while (a)
+				{
+					while (!(a & 1))
+					{
+						a >>= 1;
+
+						if ((n & 7) == 3 || (n & 7) == 5)
+							t = -t;
+					}
+
+					std::swap(a, n);
+
+					if ((a & 3) == 3 && (n & 3) == 3)
+						t = -t;
+
+					a %= n;
+				}
+
+				return (n == 1) ? t : 0;
+			}
+
+			//Jacobi symbol ( d / n ) for a small signed d and a wide odd n, by reciprocity on n mod |d|
+			//
+			template < typename U > int jacobi(int64_t d, const U& n)
+			{
+				uint64_t a = (d < 0) ? uint64_t(-d) : uint64_t(d);
+				int t = 1;
+
+				if (d < 0 && (n.back() & 3) == 3)
+					t = -t;
+
+				while (!(a & 1))
+				{
+					a >>= 1;
+
+					if ((n.back() & 7) == 3 || (n.back() & 7) == 5)
+						t = -t;
+				}
+
+				if (a == 1)
+					return t;
+
+				if ((a & 3) == 3 && (n.back() & 3) == 3)
+					t = -t;
+
+				return t * jacobi(mod_small(n, a), a);
+			}
+
+			//n = d * 2^s + c for c = 1 or -1, returns { d, s }
+			//
+			template < typename U > std::pair<U, size_t> split(const U& m)
+			{
+				size_t s = 0;
+				U d = m;
+
+				while (!(d.back() & 1))
+				{
+					d >>= 1;
+					s++;
+				}
+
+				return std::make_pair(d, s);
+			}
+
+			//Strong probable prime test to base a ( Miller-Rabin ), a < n
+			//
+			template < typename U > bool miller_rabin(const MontgomeryContext<U>& ctx, const U& a)
+			{
+				const U& n = ctx.Modulus();
+
+				auto [d, s] = split(n - U(1));
+
+				auto mul = [&](const U& x, const U& y) { return ctx.Multiply(x, y); };
+				auto sqr = [&](const U& x) { return ctx.Square(x); };
+
+				U one = ctx.One(), minus_one = n - ctx.One();
+				U x = sliding_window_pow(ctx.ToMontgomery(a), d, d.Bits() + 1, one, mul, sqr);
+
+				if (x == one || x == minus_one)
+					return true;
+
+				for (size_t i = 1; i < s; i++)
+				{
+					x = ctx.Square(x);
+
+					if (x == minus_one)
+						return true;
+
+					if (x == one)
+						return false;
+				}
+
+				return false;
+			}
+
+			//x * k mod n for a small signed k by doubling and adding, far cheaper than a full Montgomery product
+			//
+			template < typename U > U mul_small(const MontgomeryContext<U>& ctx, const U& x, int64_t k)
+			{
+				uint64_t a = (k < 0) ? uint64_t(-k) : uint64_t(k);
+				U r = x;
+
+				for (size_t i = greatest_bit(a); i-- > 0; )
+				{
+					r = ctx.Add(r, r);
+
+					if ((a >> i) & 1)
+						r = ctx.Add(r, x);
+				}
+
+				return (k < 0) ? ctx.Sub(U(), r) : r;
+			}
+
+			//x / 2 mod n, x < n
+			//
+			template < typename U > U half(const U& x, const U& n)
+			{
+				if (!(x.back() & 1))
+					return x >> 1;
+
+				U r;
+				bool carry = finite_vector_add(x, n, r);
+
+				r >>= 1;
+
+				if (carry)
+					r.SetBit(limbs<U> * bits<typename U::value_type>() - 1);
+
+				return r;
+			}
+
+			/*
+				Strong Lucas probable prime test with Selfridge's parameters: the first D in 5, -7, 9, -11, ...
+				with ( D / n ) = -1, P = 1 and Q = ( 1 - D ) / 4. n + 1 = d * 2^s, n passes when U_d = 0 or
+				V_(d * 2^r) = 0 for some r < s. Everything runs in Montgomery form, halving commutes with R.
+			*/
+
+			template < typename U > bool strong_lucas(const MontgomeryContext<U>& ctx)
+			{
+				const U& n = ctx.Modulus();
+
+				int64_t D = 5;
+
+				for (size_t i = 0; ; i++)
+				{
+					int j = jacobi(D, n);
+
+					if (j == -1)
+						break;
+
+					//n > |D| shares a factor with it
+					//
+					if (j == 0)
+						return false;
+
+					//A square never reaches ( D / n ) = -1
+					//
+					if (i == 8)
+					{
+						U r = n.ISqrt();
+
+						if (r * r == n)
+							return false;
+					}
+
+					D = (D < 0) ? 2 - D : -2 - D;
+				}
+
+				int64_t Q = (1 - D) / 4;
+
+				auto [d, s] = split(n + U(1));
+
+				U u = ctx.One(), v = ctx.One(), qk = mul_small(ctx, ctx.One(), Q);
+
+				for (size_t i = d.Bits(); i-- > 0; )
+				{
+					u = ctx.Multiply(u, v);
+					v = ctx.Sub(ctx.Square(v), ctx.Add(qk, qk));
+					qk = ctx.Square(qk);
+
+					if (window(d, i, 1))
+					{
+						U pu = ctx.Add(u, v);
+						U pv = ctx.Add(mul_small(ctx, u, D), v);
+
+						u = half(pu, n);
+						v = half(pv, n);
+						qk = mul_small(ctx, qk, Q);
+					}
+				}
+
+				U zero;
+
+				if (u == zero || v == zero)
+					return true;
+
+				for (size_t r = 1; r < s; r++)
+				{
+					v = ctx.Sub(ctx.Square(v), ctx.Add(qk, qk));
+					qk = ctx.Square(qk);
+
+					if (v == zero)
+						return true;
+				}
+
+				return false;
+			}
+		}
+	}
+
+	/*
+		Primality test, exact below 2^81 and Baillie-PSW above ( no known counterexample ).
+
+		Trial division by the odd primes below 1000 runs on single limb remainders of prime products.
+		Up to 64 bits the first 12 primes are a proven Miller-Rabin base set, up to 81 bits the first 13,
+		wider values take base 2 and a strong Lucas test. rounds adds Miller-Rabin tests to random bases.
+	*/
+
+	template < typename T, size_t S > bool IsProbablePrime(const uintv_t<T, S>& n, size_t rounds = 0)
+	{
+		using U = uintv_t<T, S>;
+		using namespace helper::prime;
+
+		if (!n)
+			return false;
+
+		size_t nb = n.Bits() + 1;
+
+		uint64_t low = helper::safegcd::low64(n.data(), S);
+
+		if (nb <= 10 && low < 1000)
+		{
+			if (low == 2)
+				return true;
+
+			for (auto p : small_primes)
+				if (p == low)
+					return true;
+
+			return false;
+		}
+
+		if (!trial_division(n))
+			return false;
+
+		if (nb <= 20 && low < small_prime_square)
+			return true;
+
+		MontgomeryContext<U> ctx(n);
+
+		if (nb <= 81)
+		{
+			size_t count = (nb <= 64) ? 12 : 13;
+
+			if (!miller_rabin(ctx, U(T(2))))
+				return false;
+
+			for (size_t i = 0; i < count - 1; i++)
+				if (!miller_rabin(ctx, U(T(small_primes[i]))))
+					return false;
+		}
+		else if (!miller_rabin(ctx, U(T(2))) || !strong_lucas(ctx))
+			return false;
+
+		for (size_t i = 0; i < rounds; i++)
+		{
+			U a;
+			a.Random();
+
+			a = (a % (n - U(T(3)))) + U(T(2));
+
+			if (!miller_rabin(ctx, a))
+				return false;
+		}
+
+		return true;
+	}
+
+	namespace helper
+	{
+		namespace prime
+		{
+			//Odd primes below 2^16 for the candidate sieve
+			//
+			inline const std::vector<uint32_t>& sieve_primes()
+			{
+				static const std::vector<uint32_t> p = []()
+				{
+					std::vector<uint32_t> r;
+					std::vector<bool> composite(size_t(1) << 16);
+
+					for (size_t i = 3; i < composite.size(); i += 2)
+					{
+						if (composite[i])
+							continue;
+
+						r.push_back(uint32_t(i));
+
+						for (size_t j = i * i; j < composite.size(); j += 2 * i)
+							composite[j] = true;
+					}
+
+					return r;
+				}();
+
+				return p;
+			}
+
+			//U from a value below 2^64
+			//
+			template < typename U > U small_value(uint64_t v)
+			{
+				using T = typename U::value_type;
+
+				U r;
+
+				for (size_t i = limbs<U>; i-- > 0 && v; )
+				{
+					r[i] = T(v);
+					v = (bits<T>() < 64) ? v >> (bits<T>() % 64) : 0;
+				}
+
+				return r;
+			}
+
+			/*
+				Sieve of the window start + 2i, i < w, by every sieve prime, start must be above 2^16.
+
+				residue[j] = start mod p[j] is kept across windows, moving to the next window adds 2w to it, so the
+				wide remainders are only formed once. alive[i] is cleared for every i with p | start + 2i.
+			*/
+
+			struct window_sieve_t
+			{
+				size_t w;
+				size_t count;
+				std::vector<uint32_t> residue;
+				std::vector<bool> alive;
+
+				template < typename U > window_sieve_t(const U& start, size_t _w) : w(_w), alive(_w)
+				{
+					auto& p = sieve_primes();
+
+					count = p.size();
+					residue.resize(count);
+
+					for (size_t j = 0; j < count; )
+					{
+						if (j + 1 < count)
+						{
+							uint64_t r = mod_small(start, uint64_t(p[j]) * p[j + 1]);
+
+							residue[j] = uint32_t(r % p[j]);
+							residue[j + 1] = uint32_t(r % p[j + 1]);
+
+							j += 2;
+						}
+						else
+						{
+							residue[j] = uint32_t(mod_small(start, p[j]));
+							j++;
+						}
+					}
+
+					Sieve();
+				}
+
+				void Sieve()
+				{
+					auto& p = sieve_primes();
+
+					std::fill(alive.begin(), alive.end(), true);
+
+					for (size_t j = 0; j < count; j++)
+					{
+						uint64_t q = p[j];
+
+						//start + 2i = 0 mod q at i = -residue / 2 mod q, 1 / 2 = ( q + 1 ) / 2
+						//
+						uint64_t i = ((q - residue[j]) % q) * ((q + 1) / 2) % q;
+
+						for (; i < w; i += q)
+							alive[i] = false;
+					}
+				}
+
+				void Next()
+				{
+					auto& p = sieve_primes();
+
+					for (size_t j = 0; j < count; j++)
+						residue[j] = uint32_t((residue[j] + 2 * uint64_t(w)) % p[j]);
+
+					Sieve();
+				}
+			};
+		}
+	}
+
+#ifndef SCALAR_T_PRIME_WINDOW
+#define SCALAR_T_PRIME_WINDOW 4096
+#endif
+
+	/*
+		Random prime of exactly bits bits, 2 <= bits <= the width of U.
+
+		A random odd start with the top bit set is sieved over SCALAR_T_PRIME_WINDOW odd candidates by the primes below 2^16,
+		only the survivors reach IsProbablePrime. The windows follow the start and wrap back to 2^(bits-1) past the top,
+		workers threads are started once and each claims the next window from an atomic counter. The prime of the lowest
+		window holding one is returned, so the result does not depend on workers.
+	*/
+
+	template < typename U > U RandomPrime(size_t bits, size_t workers = 1)
+	{
+		using T = typename U::value_type;
+		using namespace helper::prime;
+
+		constexpr size_t width = helper::limbs<U> * helper::bits<T>();
+
+		auto draw = [&]()
+		{
+			U r;
+			r.Random();
+
+			r >>= width - bits;
+			r.SetBit(bits - 1);
+			r.SetBit(0);
+
+			return r;
+		};
+
+		if (bits <= 2)
+			return U(T(bits == 2 ? 3 : 2));
+
+		if (bits <= 20)
+		{
+			while (true)
+			{
+				U r = draw();
+
+				if (IsProbablePrime(r))
+					return r;
+			}
+		}
+
+		const size_t w = SCALAR_T_PRIME_WINDOW;
+
+		//window g starts 2wg past the draw, wrapped back into [ 2^(bits-1), 2^bits )
+		//
+		U start = draw();
+
+		auto window = [&](size_t g)
+		{
+			U r = start + small_value<U>(2 * uint64_t(w) * g);
+
+			r <<= width - bits + 1;
+			r >>= width - bits + 1;
+			r.SetBit(bits - 1);
+
+			return r;
+		};
+
+		std::atomic<size_t> next{ 0 }, found{ std::numeric_limits<size_t>::max() };
+		std::mutex lock;
+		U prime;
+
+		auto work = [&]()
+		{
+			std::optional<window_sieve_t> sieve;
+			U s;
+
+			for (size_t g = next++; g < found; g = next++)
+			{
+				//the residues are only carried over when this worker claimed the window right after its last one
+				//
+				U t = window(g);
+
+				if (sieve && t == s + small_value<U>(2 * w))
+					sieve->Next();
+				else
+					sieve.emplace(t, w);
+
+				s = t;
+
+				for (size_t i = 0; i < w && g < found; i++)
+				{
+					if (!sieve->alive[i])
+						continue;
+
+					U r = s + small_value<U>(2 * i);
+
+					if (r.Bits() + 1 != bits || !IsProbablePrime(r))
+						continue;
+
+					std::lock_guard<std::mutex> guard(lock);
+
+					if (g < found)
+					{
+						prime = r;
+						found = g;
+					}
+
+					return;
+				}
+			}
+		};
+
+		std::vector<std::thread> pool;
+
+		for (size_t i = 1; i < workers; i++)
+			pool.emplace_back(work);
+
+		work();
+
+		for (auto& t : pool)
+			t.join();
+
+		return prime;
+	}
+}
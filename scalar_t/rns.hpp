@@ -0,0 +1,216 @@
+/* Copyright (C) 2020 D8DATAWORKS - All Rights Reserved */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "int.hpp"
+
+namespace scalar_t
+{
+	/*
+		Residue number system over the word primes P..., M = prod P.
+
+		A value is held as its residues x mod p_i, add, sub and mul then run independently per residue with single
+		word operations and no carries between them. Products reduce through the 2-by-1 reciprocal of each p_i.
+
+		Reconstruction is Garner's mixed radix form x = v0 + p0 * ( v1 + p1 * ( v2 + ... ) ), the inverses
+		p_j^-1 mod p_i are computed once per type, the digits are then folded into M with a single limb multiply each.
+		Value() is exact for results in [0, M) and returns them modulo 2^n like the rest of uintv_t,
+		pick the primes so that M covers the widest intermediate, prod P >= 2^2n for one full product.
+	*/
+
+	template < typename U, uint64_t... P > class rns_t
+	{
+		using T = typename U::value_type;
+		static constexpr size_t S = helper::limbs<U>;
+		static constexpr size_t L = sizeof...(P);
+		static constexpr size_t words = (S * helper::bits<T>() + 63) / 64;
+
+		using M = uintv_t<uint64_t, L>;
+
+		static_assert(L > 0, "at least one modulus");
+		static_assert(((P > 2 && (P & 1) && P < (uint64_t(1) << 63)) && ...), "moduli must be odd primes below 2^63");
+
+		static constexpr std::array<uint64_t, L> p{ P... };
+
+		struct constants_t
+		{
+			std::array<helper::divisor_t<uint64_t>, L> d{ helper::divisor_t<uint64_t>(P)... };
+
+			//inv[i][j] = p_j^-1 mod p_i for j < i
+			//
+			std::array<std::array<uint64_t, L>, L> inv{};
+		};
+
+		static uint64_t MulMod(uint64_t a, uint64_t b, const helper::divisor_t<uint64_t>& d)
+		{
+			auto [h, l] = intrinsic::umul(a, b);
+			uint64_t w[2] = { h, l };
+
+			return helper::mod_1<uint64_t>(w, 2, d);
+		}
+
+		static const constants_t& Constants()
+		{
+			static const constants_t k = []()
+			{
+				constants_t k;
+
+				for (size_t i = 1; i < L; i++)
+				{
+					for (size_t j = 0; j < i; j++)
+					{
+						//Fermat, p_j^( p_i - 2 )
+						//
+						uint64_t b = helper::mod_1<uint64_t>(&p[j], 1, k.d[i]), r = 1;
+
+						for (uint64_t e = p[i] - 2; e; e >>= 1, b = MulMod(b, b, k.d[i]))
+							if (e & 1)
+								r = MulMod(r, b, k.d[i]);
+
+						k.inv[i][j] = r;
+					}
+				}
+
+				return k;
+			}();
+
+			return k;
+		}
+
+		std::array<uint64_t, L> r{};
+
+	public:
+
+		rns_t() {}
+
+		explicit rns_t(const U& x)
+		{
+			auto& k = Constants();
+
+			std::array<uint64_t, words> w{};
+
+			for (size_t i = 0; i < S; i++)
+			{
+				size_t bit = i * helper::bits<T>();
+				w[words - 1 - bit / 64] |= uint64_t(x[S - 1 - i]) << (bit % 64);
+			}
+
+			for (size_t i = 0; i < L; i++)
+				r[i] = helper::mod_1<uint64_t>(w.data(), words, k.d[i]);
+		}
+
+		static M Modulus()
+		{
+			M m(1);
+
+			for (auto q : p)
+				helper::mul_1<uint64_t>(m.data(), m.data(), L, q);
+
+			return m;
+		}
+
+		uint64_t Residue(size_t i) const
+		{
+			return r[i];
+		}
+
+		U Value() const
+		{
+			auto& k = Constants();
+
+			std::array<uint64_t, L> v;
+
+			for (size_t i = 0; i < L; i++)
+			{
+				uint64_t t = r[i];
+
+				for (size_t j = 0; j < i; j++)
+				{
+					uint64_t vj = helper::mod_1<uint64_t>(&v[j], 1, k.d[i]);
+
+					t = MulMod(t >= vj ? t - vj : t + p[i] - vj, k.inv[i][j], k.d[i]);
+				}
+
+				v[i] = t;
+			}
+
+			M x(v[L - 1]);
+
+			for (size_t i = L - 2; i != -1; i--)
+			{
+				helper::mul_1<uint64_t>(x.data(), x.data(), L, p[i]);
+				helper::finite_vector_add(x, M(v[i]));
+			}
+
+			U result;
+
+			for (size_t i = 0; i < S; i++)
+			{
+				size_t bit = i * helper::bits<T>();
+
+				if (bit / 64 < L)
+					result[S - 1 - i] = T(x[L - 1 - bit / 64] >> (bit % 64));
+			}
+
+			return result;
+		}
+
+		rns_t operator + (const rns_t& b) const
+		{
+			rns_t s;
+
+			for (size_t i = 0; i < L; i++)
+			{
+				uint64_t t = r[i] + b.r[i];
+				s.r[i] = t >= p[i] ? t - p[i] : t;
+			}
+
+			return s;
+		}
+
+		rns_t operator - (const rns_t& b) const
+		{
+			rns_t s;
+
+			for (size_t i = 0; i < L; i++)
+				s.r[i] = r[i] >= b.r[i] ? r[i] - b.r[i] : r[i] + p[i] - b.r[i];
+
+			return s;
+		}
+
+		rns_t operator * (const rns_t& b) const
+		{
+			auto& k = Constants();
+
+			rns_t s;
+
+			for (size_t i = 0; i < L; i++)
+				s.r[i] = MulMod(r[i], b.r[i], k.d[i]);
+
+			return s;
+		}
+
+		rns_t& operator += (const rns_t& b)
+		{
+			return *this = *this + b;
+		}
+
+		rns_t& operator -= (const rns_t& b)
+		{
+			return *this = *this - b;
+		}
+
+		rns_t& operator *= (const rns_t& b)
+		{
+			return *this = *this * b;
+		}
+
+		bool operator == (const rns_t& b) const
+		{
+			return r == b.r;
+		}
+	};
+}
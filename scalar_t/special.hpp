@@ -0,0 +1,187 @@
+/* Copyright (C) 2020 D8DATAWORKS - All Rights Reserved */
+
+#pragma once
+
+#include "int.hpp"
+
+namespace scalar_t
+{
+	/*
+		Reduction modulo p = 2^K - C for a small C known at compile time.
+
+		2^K = C mod p, so x = hi * 2^K + lo folds to hi * C + lo with a single limb multiply and an add.
+		When K is within a limb of the full width, the first fold is taken at the limb boundary with C << gap
+		and only the few bits above K are folded after it, otherwise each fold shifts the whole value by K bits.
+		The last step is a subtraction of p.
+	*/
+
+	template < typename U, size_t K, typename U::value_type C > class SpecialModulus
+	{
+		using T = typename U::value_type;
+		static constexpr size_t S = helper::limbs<U>;
+		static constexpr size_t limb_bits = helper::bits<T>();
+
+		using W = uintv_t<T, 2 * S>;
+		using X = uintv_t<T, 2 * S + 1>;
+
+		static_assert(K > limb_bits && K <= S * limb_bits, "K must exceed one limb and fit U");
+		static_assert(C > 0 && C < (T(1) << (limb_bits - 1)), "C must be a small positive single limb");
+
+		//x mod 2^K in place
+		//
+		static void Truncate(X& x)
+		{
+			constexpr size_t q = K / limb_bits, r = K % limb_bits, l = 2 * S - q;
+
+			std::fill(x.begin(), x.begin() + l, T(0));
+
+			if (r)
+				x[l] &= T((T(1) << r) - 1);
+			else
+				x[l] = 0;
+		}
+
+		//2^(S * limb_bits) = C << gap mod p, when that product fits a limb the folds run on whole limbs
+		//
+		static constexpr size_t gap = S * limb_bits - K;
+		static constexpr bool aligned = gap < limb_bits && (C >> (limb_bits - 1 - gap)) == 0;
+		static constexpr T Cs = aligned ? T(C << gap) : T(0);
+
+		//x[0, n) += h * B + l, returns the carry out of x[0]
+		//
+		static bool AddLimbs(T* x, size_t n, T h, T l)
+		{
+			unsigned char carry = intrinsic::addc<T>(0, x[n - 1], l, x[n - 1]);
+			carry = intrinsic::addc<T>(carry, x[n - 2], h, x[n - 2]);
+
+			for (size_t i = n - 3; carry && i != -1; i--)
+				carry = intrinsic::addc<T>(carry, x[i], T(0), x[i]);
+
+			return carry;
+		}
+
+		static U ReduceAligned(const W& w)
+		{
+			U x;
+			std::copy(w.begin() + S, w.end(), x.begin());
+
+			T top = helper::addmul_1<T>(x.data(), w.data(), S, Cs);
+
+			while (top)
+			{
+				auto [h, l] = helper::mul(top, Cs);
+				top = AddLimbs(x.data(), S, h, l);
+			}
+
+			if constexpr (gap)
+			{
+				constexpr size_t r = limb_bits - gap;
+
+				for (T hi = x[0] >> r; hi; hi = x[0] >> r)
+				{
+					x[0] &= T((T(1) << r) - 1);
+					AddLimbs(x.data(), S, T(0), T(hi * C));
+				}
+			}
+
+			if (helper::finite_vector_greater_equal(x, modulus))
+				helper::finite_vector_subtract(x, modulus);
+
+			return x;
+		}
+
+		static U ReduceGeneric(const W& w)
+		{
+			X x, p;
+
+			std::copy(w.begin(), w.end(), x.begin() + 1);
+
+			std::copy(modulus.begin(), modulus.end(), p.begin() + S + 1);
+
+			for (X hi = x >> K; hi; hi = x >> K)
+			{
+				Truncate(x);
+
+				helper::mul_1<T>(hi.data(), hi.data(), 2 * S + 1, C);
+				helper::finite_vector_add(x, hi);
+			}
+
+			while (helper::finite_vector_greater_equal(x, p))
+				helper::finite_vector_subtract(x, p);
+
+			U result;
+			std::copy(x.begin() + S + 1, x.end(), result.begin());
+
+			return result;
+		}
+
+		static U MakeModulus()
+		{
+			U p;
+
+			if constexpr (K < S * limb_bits)
+				p.SetBit(K);
+
+			return p - U(C);
+		}
+
+		//p = 2^K - C, formed once per instantiation
+		//
+		static inline const U modulus = MakeModulus();
+
+	public:
+
+		static U Modulus()
+		{
+			return modulus;
+		}
+
+		static U Reduce(const W& w)
+		{
+			if constexpr (aligned)
+				return ReduceAligned(w);
+			else
+				return ReduceGeneric(w);
+		}
+
+		static U Reduce(const U& a)
+		{
+			W w;
+			std::copy(a.begin(), a.end(), w.begin() + S);
+
+			return Reduce(w);
+		}
+
+		static U Multiply(const U& a, const U& b)
+		{
+			return Reduce(MulWide(a, b));
+		}
+
+		static U Square(const U& a)
+		{
+			return Reduce(MulWide(a, a));
+		}
+
+		static U Add(const U& a, const U& b)
+		{
+			U s, d;
+
+			bool carry = helper::finite_vector_add(a, b, s);
+			bool borrow = helper::finite_vector_subtract(s, modulus, d);
+
+			return (carry || !borrow) ? d : s;
+		}
+
+		static U Sub(const U& a, const U& b)
+		{
+			U d;
+
+			if (helper::finite_vector_subtract(a, b, d))
+				helper::finite_vector_add(d, modulus);
+
+			return d;
+		}
+	};
+
+	template < typename U, size_t K > using MersenneModulus = SpecialModulus<U, K, 1>;
+}
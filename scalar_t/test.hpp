@@ -5,10 +5,17 @@
 
 #include <chrono>
 #include <array>
+#include <list>
 
 #include "../catch.hpp"
 
 #include "int.hpp"
+#include "montgomery.hpp"
+#include "barrett.hpp"
+#include "special.hpp"
+#include "prime.hpp"
+#include "rns.hpp"
+#include "batch.hpp"
 
 using namespace scalar_t;
 
@@ -563,6 +570,50 @@ TEST_CASE("finite_vector_fuse_multiply_add loop", "[scalar_t::uintv_t]")
 	CHECK(v2 == v1);
 }
 
+TEST_CASE("intrinsic backend", "[scalar_t::helpers]")
+{
+	{
+		auto [h, l] = mul<uint64_t>(0xffffffffffffffff, 0xffffffffffffffff);
+
+		CHECK(h == 0xfffffffffffffffe);
+		CHECK(l == 1);
+	}
+
+	{
+		auto [h, l] = mul<uint8_t>(0xf0, 0x11);
+
+		CHECK(h == 0x0f);
+		CHECK(l == 0xf0);
+	}
+
+	{
+		uint64_t t = 0xffffffffffffffff;
+
+		CHECK(add(t, uint64_t(2)));
+		CHECK(t == 1);
+		CHECK(sub(t, uint64_t(2)));
+		CHECK(t == 0xffffffffffffffff);
+		CHECK(!sub(t, uint64_t(1)));
+	}
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		uint32_t a = (uint32_t)d8u::random::Integer(), b = (uint32_t)d8u::random::Integer();
+		uint64_t wa = a, wb = b;
+
+		auto [h, l] = mul(a, b);
+		CHECK((((uint64_t)h << 32) | l) == wa * wb);
+
+		uint32_t s = a;
+		bool c = add(s, b);
+		CHECK((((uint64_t)c << 32) | s) == wa + wb);
+
+		uint32_t d = a;
+		CHECK(sub(d, b) == (b > a));
+		CHECK(d == uint32_t(a - b));
+	}
+}
+
 TEST_CASE("standing in place multiplication", "[scalar_t::helpers]")
 {
 	constexpr auto S = 4;
@@ -678,6 +729,269 @@ TEST_CASE("basic multiplication", "[scalar_t::helpers]")
 }
 
 
+TEST_CASE("product scanning multiplication", "[scalar_t::helpers]")
+{
+	for (size_t i = 0; i < 1000; i++)
+	{
+		using C = std::array<uint16_t, 4>;
+
+		uint64_t w1 = d8u::random::Integer(), w2 = d8u::random::Integer(), wp = w1 * w2;
+
+		C t1 = { uint16_t(w1 >> 48), uint16_t(w1 >> 32), uint16_t(w1 >> 16), uint16_t(w1) };
+		C t2 = { uint16_t(w2 >> 48), uint16_t(w2 >> 32), uint16_t(w2 >> 16), uint16_t(w2) };
+		C expected = { uint16_t(wp >> 48), uint16_t(wp >> 32), uint16_t(wp >> 16), uint16_t(wp) }, result;
+
+		finite_vector_multiply<uint16_t>(t1, t2, result);
+		CHECK(result == expected);
+
+		finite_vector_multiply<uint16_t>(t1, t2);
+		CHECK(t1 == expected);
+	}
+
+	{
+		using C = std::array<uint64_t, 2>;
+
+		C t1 = { 0xffffffffffffffff, 0xffffffffffffffff }, expected = { 0, 1 }, result;
+
+		finite_vector_multiply<uint64_t>(t1, t1, result);
+		CHECK(result == expected);
+
+		finite_vector_multiply<uint64_t>(t1, t1);
+		CHECK(t1 == expected);
+	}
+
+	for (size_t i = 0; i < 100; i++)
+	{
+		using U = uintv_t<uint64_t, 16>;
+
+		U a; a.Random();
+		U b; b.Random();
+		U c; c.Random();
+
+		CHECK((a * (b + c)) == (a * b + a * c));
+		CHECK((a * b) == (b * a));
+	}
+}
+
+TEST_CASE("karatsuba multiplication", "[scalar_t::helpers]")
+{
+	{
+		constexpr size_t n = 4 * karatsuba_threshold;
+
+		std::array<uint8_t, n> a, b;
+		std::array<uint8_t, 2 * n> r1, r2;
+		std::array<uint8_t, karatsuba_scratch(n)> scratch;
+
+		a.fill(0xff); b.fill(0xff);
+
+		mul_basecase(a.data(), b.data(), n, r1.data());
+		karatsuba(a.data(), b.data(), n, r2.data(), scratch.data());
+
+		CHECK(r1 == r2);
+	}
+
+	for (size_t i = 0; i < 100; i++)
+	{
+		constexpr size_t n = 4 * karatsuba_threshold;
+
+		std::array<uint64_t, n> a, b;
+		std::array<uint64_t, 2 * n> r1, r2;
+
+		for (auto& e : a) e = d8u::random::Integer();
+		for (auto& e : b) e = d8u::random::Integer();
+
+		mul_basecase(a.data(), b.data(), n, r1.data());
+		finite_vector_multiply_wide<uint64_t>(a, b, r2);
+
+		CHECK(r1 == r2);
+	}
+
+	//odd lengths split one limb short on the high half, all the way down to the threshold
+	//
+	auto odd = [](auto c)
+	{
+		constexpr size_t n = decltype(c)::value;
+
+		std::array<uint64_t, n> a, b;
+		std::array<uint64_t, 2 * n> r1, r2, r3, r4;
+		std::array<uint64_t, karatsuba_scratch(n)> scratch;
+
+		for (size_t i = 0; i < 10; i++)
+		{
+			for (auto& e : a) e = (i == 0) ? ~uint64_t(0) : d8u::random::Integer();
+			for (auto& e : b) e = (i == 0) ? ~uint64_t(0) : d8u::random::Integer();
+
+			mul_basecase(a.data(), b.data(), n, r1.data());
+			karatsuba(a.data(), b.data(), n, r2.data(), scratch.data());
+
+			mul_basecase(a.data(), a.data(), n, r3.data());
+			karatsuba_sqr(a.data(), n, r4.data(), scratch.data());
+
+			CHECK(r1 == r2);
+			CHECK(r3 == r4);
+		}
+	};
+
+	odd(std::integral_constant<size_t, karatsuba_threshold + 1>());
+	odd(std::integral_constant<size_t, 2 * karatsuba_threshold + 1>());
+	odd(std::integral_constant<size_t, 3 * karatsuba_threshold + 1>());
+
+	{
+		using U = uintv_t<uint32_t, short_product_threshold>;
+
+		U a; a.Random();
+		U b; b.Random();
+		U c; c.Random();
+
+		CHECK((a * (b + c)) == (a * b + a * c));
+
+		auto f = c;
+		f.FMADD(a, b);
+		CHECK(f == c + a * b);
+
+		f.FM2IAD(a, b);
+		CHECK(f == c);
+	}
+}
+
+TEST_CASE("short product multiplication", "[scalar_t::helpers]")
+{
+	{
+		constexpr size_t n = 2 * short_product_threshold + 3;
+
+		std::array<uint8_t, n> a, b, r1, r2;
+		std::array<uint8_t, short_product_scratch(n)> scratch;
+
+		a.fill(0xff); b.fill(0xff);
+
+		mullo_basecase(a.data(), b.data(), n, r1.data());
+		mulders(a.data(), b.data(), n, r2.data(), scratch.data());
+
+		CHECK(r1 == r2);
+	}
+
+	for (size_t i = 0; i < 10; i++)
+	{
+		constexpr size_t n = 2 * short_product_threshold;
+
+		std::array<uint64_t, n> a, b, r1, r2;
+		std::array<uint64_t, 2 * n> wide;
+
+		for (auto& e : a) e = d8u::random::Integer();
+		for (auto& e : b) e = d8u::random::Integer();
+
+		mullo_basecase(a.data(), b.data(), n, r1.data());
+		finite_vector_multiply<uint64_t>(a, b, r2);
+		finite_vector_multiply_wide<uint64_t>(a, b, wide);
+
+		CHECK(r1 == r2);
+		CHECK(std::equal(r1.begin(), r1.end(), wide.begin() + n));
+	}
+}
+
+TEST_CASE("squaring", "[scalar_t::helpers]")
+{
+	{
+		constexpr size_t n = 4 * karatsuba_threshold;
+
+		std::array<uint8_t, n> a;
+		std::array<uint8_t, 2 * n> r1, r2, r3;
+		std::array<uint8_t, karatsuba_scratch(n)> scratch;
+
+		a.fill(0xff);
+
+		mul_basecase(a.data(), a.data(), n, r1.data());
+		sqr_basecase(a.data(), n, r2.data(), 2 * n);
+		karatsuba_sqr(a.data(), n, r3.data(), scratch.data());
+
+		CHECK(r1 == r2);
+		CHECK(r1 == r3);
+	}
+
+	for (size_t i = 0; i < 10; i++)
+	{
+		constexpr size_t n = 2 * short_product_threshold + 1;
+
+		std::array<uint64_t, n> a, r1, r2;
+		std::array<uint64_t, short_product_scratch(n)> scratch;
+
+		for (auto& e : a) e = d8u::random::Integer();
+
+		mullo_basecase(a.data(), a.data(), n, r1.data());
+		mulders_sqr(a.data(), n, r2.data(), scratch.data());
+
+		CHECK(r1 == r2);
+	}
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		using U = uintv_t<uint16_t, 4>;
+
+		uint64_t w = d8u::random::Integer(), ws = w * w;
+
+		U v{ uint16_t(w >> 48), uint16_t(w >> 32), uint16_t(w >> 16), uint16_t(w) };
+		U expected{ uint16_t(ws >> 48), uint16_t(ws >> 32), uint16_t(ws >> 16), uint16_t(ws) };
+
+		CHECK(v.Square() == expected);
+		CHECK(v * v == expected);
+
+		auto x = v;
+		x *= x;
+		CHECK(x == expected);
+
+		v.SquareInPlace();
+		CHECK(v == expected);
+	}
+
+	for (size_t i = 0; i < 100; i++)
+	{
+		using U = uintv_t<uint64_t, 16>;
+
+		U v; v.Random();
+		U c = v;
+
+		CHECK(v.Square() == v * U(c));
+	}
+}
+
+TEST_CASE("widening multiplication", "[scalar_t::uintv_t]")
+{
+	for (size_t i = 0; i < 1000; i++)
+	{
+		using U = uintv_t<uint32_t, 1>;
+
+		uint32_t a = (uint32_t)d8u::random::Integer(), b = (uint32_t)d8u::random::Integer();
+		uint64_t w = (uint64_t)a * b;
+
+		CHECK((MulWide(U(a), U(b)) == uintv_t<uint32_t, 2>(uint32_t(w >> 32), uint32_t(w))));
+		CHECK(MulHigh(U(a), U(b)) == U(uint32_t(w >> 32)));
+	}
+
+	for (size_t i = 0; i < 10; i++)
+	{
+		constexpr size_t n = 2 * karatsuba_threshold;
+		using U = uintv_t<uint64_t, n>;
+
+		U a; a.Random();
+		U b; b.Random();
+
+		auto w = MulWide(a, b);
+		auto h = MulHigh(a, b);
+
+		CHECK(std::equal(w.begin() + n, w.end(), (a * b).begin()));
+		CHECK(std::equal(w.begin(), w.begin() + n, h.begin()));
+
+		auto s = MulWide(a, a);
+		uintv_t<uint64_t, 2 * n> wa, wb;
+
+		std::copy(a.begin(), a.end(), wa.begin() + n);
+		std::copy(b.begin(), b.end(), wb.begin() + n);
+
+		CHECK(w == wa * wb);
+		CHECK(s == wa * wa);
+	}
+}
+
 TEST_CASE("basic addition", "[scalar_t::helpers]")
 {
 	constexpr auto S = 4;
@@ -735,6 +1049,52 @@ TEST_CASE("basic addition", "[scalar_t::helpers]")
 	}
 }
 
+TEST_CASE("carry chain", "[scalar_t::helpers]")
+{
+	using C = std::array<uint64_t, 2>;
+
+	{
+		C t1 = { 0xffffffffffffffff, 0xffffffffffffffff }, t2 = { 0, 1 }, expected = { 0, 0 }, result;
+
+		CHECK(finite_vector_add(t1, t2, result));
+		CHECK(std::equal(result.begin(), result.end(), expected.begin()));
+		CHECK(finite_vector_subtract(result, t2));
+		CHECK(std::equal(result.begin(), result.end(), t1.begin()));
+	}
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		using C32 = std::array<uint32_t, 2>;
+
+		uint64_t w1 = d8u::random::Integer(), w2 = d8u::random::Integer();
+		uint64_t ws = w1 + w2, wd = w1 - w2;
+
+		C32 t1 = { uint32_t(w1 >> 32), uint32_t(w1) }, t2 = { uint32_t(w2 >> 32), uint32_t(w2) }, sum, difference;
+
+		CHECK(finite_vector_add(t1, t2, sum) == (ws < w1));
+		CHECK(finite_vector_subtract(t1, t2, difference) == (w2 > w1));
+
+		CHECK((sum == C32{ uint32_t(ws >> 32), uint32_t(ws) }));
+		CHECK((difference == C32{ uint32_t(wd >> 32), uint32_t(wd) }));
+
+		finite_vector_add(t1, t1);
+		CHECK((t1 == C32{ uint32_t((w1 << 1) >> 32), uint32_t(w1 << 1) }));
+	}
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		using U = uintv_t<uint64_t, 16>;
+
+		U a; a.Random();
+		U b; b.Random();
+
+		auto c = a + b;
+		c -= b;
+
+		CHECK(c == a);
+	}
+}
+
 TEST_CASE("addition overflow", "[scalar_t::uintv_t]")
 {
 	{
@@ -967,127 +1327,449 @@ TEST_CASE("Division", "[scalar_t::uintv_t]")
 
 
 
-TEST_CASE("MultiplicativeInverse", "[scalar_t::uintv_t]")
+TEST_CASE("Long Division", "[scalar_t::uintv_t]")
 {
-	using U = uintv_t<uint8_t, 2>;
-	U v = { 0x21,0xe7 }, rr = { 0x61, 0xd7 }; // 8679
-	
-	auto mul_inv = v.MultiplicativeInverse();
+	for (size_t i = 0; i < 10000; i++)
+	{
+		using U = uintv_t<uint16_t, 4>;
 
-	v *= mul_inv;
+		uint64_t n = d8u::random::Integer(), d = d8u::random::Integer() >> (d8u::random::Integer() % 64);
 
-	CHECK(v == 1);
-}
+		if (!d)
+			d = 1;
 
-TEST_CASE("Specific Misses", "[scalar_t::uintv_t]")
-{
-	{
-		using U = uintv_t<uint64_t, 2>;
-		U v("cb645cdfeec89666 914da98986504d99");
+		U un{ uint16_t(n >> 48), uint16_t(n >> 32), uint16_t(n >> 16), uint16_t(n) };
+		U ud{ uint16_t(d >> 48), uint16_t(d >> 32), uint16_t(d >> 16), uint16_t(d) };
 
-		auto r = v.MultiplicativeInverse();
+		uint64_t q = n / d, m = n % d;
 
-		v *= r;
+		auto [uq, um] = un.Divide(ud);
 
-		CHECK(v == 1);
+		CHECK(uq == U(uint16_t(q >> 48), uint16_t(q >> 32), uint16_t(q >> 16), uint16_t(q)));
+		CHECK(um == U(uint16_t(m >> 48), uint16_t(m >> 32), uint16_t(m >> 16), uint16_t(m)));
 	}
-}
 
-TEST_CASE("MultiplicativeInverse 128bit", "[scalar_t::uintv_t]")
-{
-	using U = uintv_t<uint64_t, 2>;
-	auto constexpr rep = 10;
+	{
+		using U = uintv_t<uint64_t, 4>;
 
-	for (size_t i = 0; i < rep; i++)
+		U n{ 0x8000000000000000, 0, 0, 0 }, d{ 0, 0, 0x8000000000000000, 1 };
+
+		auto [q, m] = n.Divide(d);
+
+		CHECK(q * d + m == n);
+		CHECK(finite_vector_greater(d, m));
+	}
+
+	for (size_t i = 0; i < 1000; i++)
 	{
-		U v; v.Random();
-		U c = v;
+		using U = uintv_t<uint64_t, 16>;
 
-		if (v % 2 == 0)
-			++v;
+		U n; n.Random();
+		U d; d.Random();
 
-		auto mul_inv = v.MultiplicativeInverse();
+		d >>= d8u::random::Integer() % (64 * 16);
 
-		v *= mul_inv;
+		if (!d)
+			continue;
 
-		if (v != 1)
-			std::cout << c.string() << std::endl;
+		auto [q, m] = n.Divide(d);
 
-		CHECK(v == 1);
+		CHECK(q * d + m == n);
+		CHECK(finite_vector_greater(d, m));
+		CHECK(n / d == q);
+		CHECK(n % d == m);
 	}
-}
-
-TEST_CASE("MultiplicativeInverse 256bit", "[scalar_t::uintv_t]")
-{
-	using U = uintv_t<uint64_t, 4>;
-	auto constexpr rep = 10;
 
-	for (size_t i = 0; i < rep; i++)
 	{
-		U v; v.Random();
+		using U = uintv_t<uint8_t, 8>;
 
-		if (v % 2 == 0)
-			++v;
-
-		auto mul_inv = v.MultiplicativeInverse();
+		U n{ 0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff }, d{ 0,0,0,0,0xff,0xff,0xff,0xff };
 
-		v *= mul_inv;
+		auto [q, m] = n.Divide(d);
 
-		CHECK(v == 1);
+		CHECK(q == U(0,0,0,1,0,0,0,1));
+		CHECK(m == U(0));
 	}
 }
 
-TEST_CASE("MultiplicativeInverse 512bit", "[scalar_t::uintv_t]")
+TEST_CASE("Single Limb Division", "[scalar_t::uintv_t]")
 {
-	using U = uintv_t<uint64_t, 8>;
-	auto constexpr rep = 10;
-
-	for (size_t i = 0; i < rep; i++)
+	for (size_t i = 0; i < 10000; i++)
 	{
-		U v; v.Random();
+		using U = uintv_t<uint16_t, 4>;
 
-		if (v % 2 == 0)
-			++v;
+		uint64_t n = d8u::random::Integer();
+		uint16_t d = uint16_t(d8u::random::Integer() >> (d8u::random::Integer() % 16));
 
-		auto mul_inv = v.MultiplicativeInverse();
+		if (!d)
+			d = 3;
 
-		v *= mul_inv;
+		U un{ uint16_t(n >> 48), uint16_t(n >> 32), uint16_t(n >> 16), uint16_t(n) };
 
-		CHECK(v == 1);
-	}
-}
+		uint64_t q = n / d;
+		auto [uq, r] = un.DivRem(d);
 
-TEST_CASE("MultiplicativeInverse 1024bit", "[scalar_t::uintv_t]")
-{
-	using U = uintv_t<uint64_t, 16>;
-	auto constexpr rep = 1;
+		CHECK(uq == U(uint16_t(q >> 48), uint16_t(q >> 32), uint16_t(q >> 16), uint16_t(q)));
+		CHECK(r == n % d);
+		CHECK(un % d == n % d);
+	}
 
-	for (size_t i = 0; i < rep; i++)
 	{
-		U v; v.Random();
+		using U = uintv_t<uint64_t, 16>;
 
-		if (v % 2 == 0)
-			++v;
+		divisor_t<uint64_t> ten(10);
 
-		auto mul_inv = v.MultiplicativeInverse();
+		for (size_t i = 0; i < 100; i++)
+		{
+			U n; n.Random();
 
-		v *= mul_inv;
+			auto [q, r] = n.DivRem(ten);
+			auto [q2, m2] = n.Divide(10);
 
-		CHECK(v == 1);
+			CHECK(q == q2);
+			CHECK(m2 == r);
+			CHECK(n % ten == r);
+			CHECK(q * 10 + r == n);
+		}
 	}
-}
-
-TEST_CASE("MultiplicativeInverse 2048bit", "[scalar_t::uintv_t]")
-{
-	using U = uintv_t<uint64_t, 32>;
-	auto constexpr rep = 1;
 
-	for (size_t i = 0; i < rep; i++)
 	{
-		U v; v.Random();
+		using U = uintv_t<uint64_t, 2>;
 
-		if (v % 2 == 0)
-			++v;
+		U n("ffffffffffffffff ffffffffffffffff");
+
+		CHECK(n % 0xffffffffffffffff == 0);
+		CHECK(n % 0x8000000000000000 == 0x7fffffffffffffff);
+		CHECK(n % 7 == 3);
+	}
+}
+
+TEST_CASE("MultiplicativeInverse", "[scalar_t::uintv_t]")
+{
+	using U = uintv_t<uint8_t, 2>;
+	U v = { 0x21,0xe7 }, rr = { 0x61, 0xd7 }; // 8679
+	
+	auto mul_inv = v.MultiplicativeInverse();
+
+	v *= mul_inv;
+
+	CHECK(v == 1);
+}
+
+TEST_CASE("MultiplicativeInverse even", "[scalar_t::uintv_t]")
+{
+	for (size_t i = 0; i < 100; i++)
+	{
+		using U = uintv_t<uint8_t, 3>;
+
+		U v; v.Random();
+		v[2] &= 0xfe;
+
+		CHECK(v.MultiplicativeInverse() == 0);
+	}
+
+	for (size_t i = 0; i < 10000; i++)
+	{
+		using U = uintv_t<uint8_t, 3>;
+
+		U v; v.Random();
+		v[2] |= 1;
+
+		CHECK(v * v.MultiplicativeInverse() == 1);
+	}
+
+	{
+		using U = uintv_t<uint64_t, 5>;
+
+		U v; v.Random();
+		v[4] |= 1;
+
+		CHECK(v * v.MultiplicativeInverse() == 1);
+	}
+
+	{
+		using U = uintv_t<uint64_t, 2 * short_product_threshold + 5>;
+
+		U v; v.Random();
+		v.back() |= 1;
+
+		CHECK(v * v.MultiplicativeInverse() == 1);
+	}
+}
+
+TEST_CASE("Gcd", "[scalar_t::uintv_t]")
+{
+	auto gcd64 = [](uint64_t a, uint64_t b)
+	{
+		while (b)
+		{
+			auto t = a % b;
+			a = b;
+			b = t;
+		}
+
+		return a;
+	};
+
+	for (size_t i = 0; i < 10000; i++)
+	{
+		using U = uintv_t<uint16_t, 4>;
+
+		uint64_t a = d8u::random::Integer() >> (d8u::random::Integer() % 64), b = d8u::random::Integer() >> (d8u::random::Integer() % 64);
+		uint64_t k = d8u::random::Integer() % 1000 + 1;
+
+		if (a < (uint64_t)-1 / k && b < (uint64_t)-1 / k)
+		{
+			a *= k;
+			b *= k;
+		}
+
+		U ua{ uint16_t(a >> 48), uint16_t(a >> 32), uint16_t(a >> 16), uint16_t(a) };
+		U ub{ uint16_t(b >> 48), uint16_t(b >> 32), uint16_t(b >> 16), uint16_t(b) };
+
+		uint64_t g = gcd64(a, b);
+
+		CHECK(ua.Gcd(ub) == U(uint16_t(g >> 48), uint16_t(g >> 32), uint16_t(g >> 16), uint16_t(g)));
+
+		auto [ug, x, y] = ua.ExtendedGcd(ub);
+
+		CHECK(ug == ua.Gcd(ub));
+		CHECK(ua * x + ub * y == ug);
+	}
+
+	for (size_t i = 0; i < 100; i++)
+	{
+		using U = uintv_t<uint64_t, 16>;
+
+		U a; a.Random();
+		U b; b.Random();
+		U k; k.Random();
+
+		a >>= 300; b >>= 300; k >>= 800;
+
+		if (!k)
+			continue;
+
+		a *= k; b *= k;
+
+		auto [g, x, y] = a.ExtendedGcd(b);
+
+		CHECK(a * x + b * y == g);
+		CHECK(a % g == 0);
+		CHECK(b % g == 0);
+		CHECK(g % k == 0);
+		CHECK((a / g).Gcd(b / g) == 1);
+	}
+
+	{
+		using U = uintv_t<uint64_t, 4>;
+
+		U a; a.Random();
+
+		CHECK(a.Gcd(0) == a);
+		CHECK(U(0).Gcd(a) == a);
+		CHECK(a.Gcd(a) == a);
+	}
+}
+
+TEST_CASE("ModInverse", "[scalar_t::uintv_t]")
+{
+	for (uint32_t m = 1; m < 256; m += 2)
+	{
+		using U = uintv_t<uint8_t, 1>;
+
+		for (uint32_t x = 0; x < 256; x++)
+		{
+			uint32_t a = x % m, b = m;
+
+			while (b)
+			{
+				auto t = a % b;
+				a = b;
+				b = t;
+			}
+
+			auto inv = U(uint8_t(x)).ModInverse(U(uint8_t(m)));
+
+			if (a == 1 && m > 1)
+				CHECK((x * inv[0]) % m == 1);
+			else
+				CHECK(inv == 0);
+		}
+	}
+
+	auto check = [](auto x, auto m)
+	{
+		using U = decltype(x);
+		using T = typename U::value_type;
+		using W = uintv_t<T, 2 * limbs<U>>;
+
+		auto inv = x.ModInverse(m);
+
+		W wm, wide = MulWide(x, inv);
+		std::copy(m.begin(), m.end(), wm.end() - limbs<U>);
+
+		CHECK(wide % wm == 1);
+	};
+
+	for (size_t i = 0; i < 100; i++)
+	{
+		using U = uintv_t<uint64_t, 4>;
+
+		U x; x.Random();
+		U m; m.Random();
+		m.back() |= 1;
+
+		if (x.Gcd(m) == 1)
+			check(x, m);
+	}
+
+	for (size_t i = 0; i < 10; i++)
+	{
+		using U = uintv_t<uint64_t, 32>;
+
+		U x; x.Random();
+		U m; m.Random();
+		m.back() |= 1;
+
+		if (x.Gcd(m) == 1)
+			check(x, m);
+	}
+
+	for (size_t i = 0; i < 100; i++)
+	{
+		using U = uintv_t<uint16_t, 5>;
+
+		U x; x.Random();
+		U m; m.Random();
+		m.back() |= 1;
+
+		if (x.Gcd(m) == 1)
+			check(x, m);
+		else
+			CHECK(x.ModInverse(m) == 0);
+	}
+
+	{
+		using U = uintv_t<uint64_t, 4>;
+
+		U m; m.Random();
+		m.back() &= ~uint64_t(1);
+
+		CHECK(U(3).ModInverse(m) == 0);
+		CHECK(U(0).ModInverse(U(7)) == 0);
+	}
+}
+
+TEST_CASE("Specific Misses", "[scalar_t::uintv_t]")
+{
+	{
+		using U = uintv_t<uint64_t, 2>;
+		U v("cb645cdfeec89666 914da98986504d99");
+
+		auto r = v.MultiplicativeInverse();
+
+		v *= r;
+
+		CHECK(v == 1);
+	}
+}
+
+TEST_CASE("MultiplicativeInverse 128bit", "[scalar_t::uintv_t]")
+{
+	using U = uintv_t<uint64_t, 2>;
+	auto constexpr rep = 10;
+
+	for (size_t i = 0; i < rep; i++)
+	{
+		U v; v.Random();
+		U c = v;
+
+		if (v % 2 == 0)
+			++v;
+
+		auto mul_inv = v.MultiplicativeInverse();
+
+		v *= mul_inv;
+
+		if (v != 1)
+			std::cout << c.string() << std::endl;
+
+		CHECK(v == 1);
+	}
+}
+
+TEST_CASE("MultiplicativeInverse 256bit", "[scalar_t::uintv_t]")
+{
+	using U = uintv_t<uint64_t, 4>;
+	auto constexpr rep = 10;
+
+	for (size_t i = 0; i < rep; i++)
+	{
+		U v; v.Random();
+
+		if (v % 2 == 0)
+			++v;
+
+		auto mul_inv = v.MultiplicativeInverse();
+
+		v *= mul_inv;
+
+		CHECK(v == 1);
+	}
+}
+
+TEST_CASE("MultiplicativeInverse 512bit", "[scalar_t::uintv_t]")
+{
+	using U = uintv_t<uint64_t, 8>;
+	auto constexpr rep = 10;
+
+	for (size_t i = 0; i < rep; i++)
+	{
+		U v; v.Random();
+
+		if (v % 2 == 0)
+			++v;
+
+		auto mul_inv = v.MultiplicativeInverse();
+
+		v *= mul_inv;
+
+		CHECK(v == 1);
+	}
+}
+
+TEST_CASE("MultiplicativeInverse 1024bit", "[scalar_t::uintv_t]")
+{
+	using U = uintv_t<uint64_t, 16>;
+	auto constexpr rep = 1;
+
+	for (size_t i = 0; i < rep; i++)
+	{
+		U v; v.Random();
+
+		if (v % 2 == 0)
+			++v;
+
+		auto mul_inv = v.MultiplicativeInverse();
+
+		v *= mul_inv;
+
+		CHECK(v == 1);
+	}
+}
+
+TEST_CASE("MultiplicativeInverse 2048bit", "[scalar_t::uintv_t]")
+{
+	using U = uintv_t<uint64_t, 32>;
+	auto constexpr rep = 1;
+
+	for (size_t i = 0; i < rep; i++)
+	{
+		U v; v.Random();
+
+		if (v % 2 == 0)
+			++v;
 
 		auto mul_inv = v.MultiplicativeInverse();
 
@@ -1115,4 +1797,963 @@ TEST_CASE("MultiplicativeInverse 4096bit", "[scalar_t::uintv_t]")
 
 		CHECK(v == 1);
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE("MontgomeryContext", "[scalar_t::MontgomeryContext]")
+{
+	auto reference = [](auto a, auto b, auto n)
+	{
+		using U = decltype(a);
+		using T = typename U::value_type;
+		using W = uintv_t<T, 2 * limbs<U>>;
+
+		W wn, m = MulWide(a, b) % [&]() { std::copy(n.begin(), n.end(), wn.end() - limbs<U>); return wn; }();
+
+		U r;
+		std::copy(m.end() - limbs<U>, m.end(), r.begin());
+
+		return r;
+	};
+
+	auto check = [&](auto n)
+	{
+		using U = decltype(n);
+
+		MontgomeryContext<U> ctx(n);
+
+		U a; a.Random(); a = a % n;
+		U b; b.Random(); b = b % n;
+
+		auto ma = ctx.ToMontgomery(a), mb = ctx.ToMontgomery(b);
+
+		CHECK(ctx.FromMontgomery(ma) == a);
+		CHECK(ctx.FromMontgomery(ctx.One()) == 1);
+		CHECK(ctx.FromMontgomery(ctx.Multiply(ma, mb)) == reference(a, b, n));
+		CHECK(ctx.FromMontgomery(ctx.Square(ma)) == reference(a, a, n));
+		CHECK(ctx.Square(ma) == ctx.Multiply(ma, ma));
+		CHECK(ctx.Sub(ctx.Add(ma, mb), mb) == ma);
+		CHECK(ctx.Add(ma, ctx.Sub(U(0), ma)) == 0);
+
+		//unreduced inputs and the largest Reduce input n * R - 1 carry through every limb
+		//
+		U full; full.BinaryInvert();
+		U r; r.Random();
+
+		CHECK(ctx.ToMontgomery(full) == ctx.ToMontgomery(full % n));
+		CHECK(ctx.ToMontgomery(r) == ctx.ToMontgomery(r % n));
+
+		uintv_t<typename U::value_type, 2 * limbs<U>> w;
+		std::copy(n.begin(), n.end(), w.begin());
+		w = w - decltype(w)(1);
+
+		CHECK(ctx.Reduce(w) == ctx.Sub(U(0), ctx.FromMontgomery(U(1))));
+	};
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		using U = uintv_t<uint8_t, 3>;
+
+		U n; n.Random(); n.back() |= 1;
+
+		if (n != 1)
+			check(n);
+	}
+
+	for (size_t i = 0; i < 100; i++)
+	{
+		using U = uintv_t<uint64_t, 4>;
+
+		U n; n.Random(); n.back() |= 1;
+		check(n);
+
+		U top("ffffffffffffffff ffffffffffffffff ffffffffffffffff ffffffffffffffff");
+		check(top);
+	}
+
+	for (size_t i = 0; i < 10; i++)
+	{
+		using U = uintv_t<uint32_t, 33>;
+
+		U n; n.Random(); n.back() |= 1;
+		check(n);
+
+		//from adx::threshold limbs the row kernels take over where the CPU has them
+		//
+		using V = uintv_t<uint64_t, 16>;
+
+		V m; m.Random(); m.back() |= 1;
+		check(m);
+
+		V top; top.BinaryInvert();
+		check(top);
+	}
+}
+
+TEST_CASE("BarrettContext", "[scalar_t::BarrettContext]")
+{
+	auto check = [](auto m, size_t top)
+	{
+		using U = decltype(m);
+		using T = typename U::value_type;
+		constexpr size_t n = limbs<U>;
+		using W = uintv_t<T, 2 * n>;
+
+		std::fill(m.begin(), m.begin() + top, T(0));
+
+		if (m == 0)
+			return;
+
+		BarrettContext<U> ctx(m);
+
+		W x, wm;
+		x.Random();
+		std::copy(m.begin(), m.end(), wm.end() - n);
+
+		auto expect = x % wm;
+
+		U r = ctx.Reduce(x);
+		CHECK(std::equal(r.begin(), r.end(), expect.end() - n));
+		CHECK(std::all_of(expect.begin(), expect.end() - n, [](auto l) { return l == 0; }));
+
+		U a; a.Random(); a = a % m;
+		U b; b.Random(); b = b % m;
+
+		auto p = MulWide(a, b) % wm;
+		r = ctx.Multiply(a, b);
+		CHECK(std::equal(r.begin(), r.end(), p.end() - n));
+	};
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		uintv_t<uint8_t, 3> m; m.Random();
+		check(m, i % 3);
+	}
+
+	for (size_t i = 0; i < 100; i++)
+	{
+		uintv_t<uint64_t, 4> m; m.Random();
+		check(m, i % 4);
+
+		uintv_t<uint32_t, 17> w; w.Random();
+		check(w, i % 17);
+	}
+
+	for (size_t k = 0; k < 4; k++)
+	{
+		uintv_t<uint64_t, 4> power;
+		power[3 - k] = 1;
+		check(power, 0);
+	}
+
+	uintv_t<uint64_t, 4> top("ffffffffffffffff ffffffffffffffff ffffffffffffffff ffffffffffffffff");
+	check(top, 0);
+}
+
+TEST_CASE("BarrettContext quotient bound", "[scalar_t::BarrettContext]")
+{
+	//x = m * ( q + 1 ) - 1 leaves the largest remainder, the estimate is furthest below q there
+	//
+	auto check = [](auto m, size_t top)
+	{
+		using U = decltype(m);
+		using T = typename U::value_type;
+		constexpr size_t n = limbs<U>;
+		using W = uintv_t<T, 2 * n>;
+
+		std::fill(m.begin(), m.begin() + top, T(0));
+
+		if (m == 0)
+			return;
+
+		BarrettContext<U> ctx(m);
+
+		W wm, one(1);
+		std::copy(m.begin(), m.end(), wm.end() - n);
+
+		auto last = wm - one;
+
+		auto reduce = [&](const W& x)
+		{
+			U r = ctx.Reduce(x);
+			auto expect = x % wm;
+
+			CHECK(std::equal(r.begin(), r.end(), expect.end() - n));
+			CHECK(r < m);
+		};
+
+		W x; x.Random();
+		x = x - x % wm;
+
+		if (x + last < x)
+			x = x - wm;
+
+		reduce(x + last);
+		reduce(x);
+
+		W all; all = all - one;
+		reduce(all);
+
+		U a = m - U(1);
+		U r = ctx.Multiply(a, a);
+		CHECK(r == ((m == U(1)) ? U(0) : U(1)));
+	};
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		uintv_t<uint8_t, 3> m; m.Random();
+		check(m, i % 3);
+
+		//smallest top limb, mu at its largest
+		//
+		m[i % 3] = 1;
+		check(m, i % 3);
+	}
+
+	for (size_t i = 0; i < 100; i++)
+	{
+		uintv_t<uint64_t, 4> m; m.Random();
+		check(m, i % 4);
+
+		m[i % 4] = 1;
+		check(m, i % 4);
+
+		uintv_t<uint32_t, 17> w; w.Random();
+		check(w, i % 17);
+
+		w[i % 17] = 1;
+		check(w, i % 17);
+	}
+
+	for (size_t k = 0; k < 4; k++)
+	{
+		uintv_t<uint64_t, 4> power;
+		power[3 - k] = 1;
+		check(power, 0);
+
+		power.back() |= 1;
+		check(power, 0);
+	}
+}
+
+TEST_CASE("Pow and ModPow", "[scalar_t::uintv_t::Pow]")
+{
+	auto square_and_multiply = [](auto x, auto e, auto mul)
+	{
+		decltype(x) r(1);
+
+		for (size_t i = limbs<decltype(e)> * sizeof(e.back()) * 8; i-- > 0; )
+		{
+			r = mul(r, r);
+
+			if ((e >> i).back() & 1)
+				r = mul(r, x);
+		}
+
+		return r;
+	};
+
+	{
+		using U = uintv_t<uint64_t, 4>;
+
+		for (size_t i = 0; i < 50; i++)
+		{
+			U x, e; x.Random(); e.Random();
+
+			e >>= (i * 5) % 256;
+
+			auto expect = square_and_multiply(x, e, [](const U& a, const U& b) { return a * b; });
+
+			CHECK(x.Pow(e) == expect);
+			CHECK(x.Pow<true>(e) == expect);
+		}
+
+		U x; x.Random();
+		CHECK(x.Pow(U(0)) == 1);
+		CHECK(x.Pow(U(1)) == x);
+		CHECK(x.Pow<true>(U(0)) == 1);
+		CHECK(U(3).Pow(U(5)) == 243);
+	}
+
+	auto modular = [&](auto n, size_t count)
+	{
+		using U = decltype(n);
+		using T = typename U::value_type;
+		constexpr size_t s = limbs<U>;
+
+		MontgomeryContext<U> ctx(n);
+
+		auto mulmod = [&](const U& a, const U& b)
+		{
+			uintv_t<T, 2 * s> wn;
+			std::copy(n.begin(), n.end(), wn.end() - s);
+
+			auto m = MulWide(a, b) % wn;
+
+			U r;
+			std::copy(m.end() - s, m.end(), r.begin());
+
+			return r;
+		};
+
+		for (size_t i = 0; i < count; i++)
+		{
+			U x, e; x.Random(); e.Random();
+
+			e >>= i % (s * sizeof(T) * 8);
+
+			auto expect = square_and_multiply(x % n, e, mulmod);
+
+			CHECK(x.ModPow(e, ctx) == expect);
+			CHECK(x.template ModPow<true>(e, ctx) == expect);
+		}
+	};
+
+	for (size_t i = 0; i < 20; i++)
+	{
+		uintv_t<uint64_t, 4> n; n.Random(); n.back() |= 1;
+		modular(n, 5);
+
+		uintv_t<uint8_t, 5> m; m.Random(); m.back() |= 1;
+
+		if (m != 1)
+			modular(m, 5);
+	}
+
+	uintv_t<uint64_t, 16> n; n.Random(); n.back() |= 1;
+	modular(n, 3);
+
+	//Fermat, a^(p-1) = 1 mod p
+	//
+	using U = uintv_t<uint64_t, 4>;
+	U p("0 0 0 ffffffffffffffc5"), a(12345);
+	MontgomeryContext<U> ctx(p);
+	CHECK(a.ModPow(p - U(1), ctx) == 1);
+	CHECK(a.ModPow<true>(p - U(1), ctx) == 1);
+}
+
+TEST_CASE("SpecialModulus", "[scalar_t::SpecialModulus]")
+{
+	auto check = [](auto ctx, size_t count)
+	{
+		using P = decltype(ctx);
+		using U = decltype(P::Modulus());
+		using T = typename U::value_type;
+		constexpr size_t n = limbs<U>;
+		using W = uintv_t<T, 2 * n>;
+
+		U p = P::Modulus();
+		W wp;
+		std::copy(p.begin(), p.end(), wp.end() - n);
+
+		auto narrow = [](const W& w) { U r; std::copy(w.end() - n, w.end(), r.begin()); return r; };
+
+		for (size_t i = 0; i < count; i++)
+		{
+			W x; x.Random();
+			CHECK(P::Reduce(x) == narrow(x % wp));
+
+			U a, b; a.Random(); b.Random();
+			a = a % p; b = b % p;
+
+			CHECK(P::Multiply(a, b) == narrow(MulWide(a, b) % wp));
+			CHECK(P::Square(a) == narrow(MulWide(a, a) % wp));
+			CHECK(P::Sub(P::Add(a, b), b) == a);
+		}
+
+		W top; top.BinaryInvert();
+		CHECK(P::Reduce(top) == narrow(top % wp));
+
+		U pm1 = p - U(1);
+		CHECK(P::Multiply(pm1, pm1) == 1);
+		CHECK(P::Add(pm1, U(1)) == 0);
+	};
+
+	check(SpecialModulus<uintv_t<uint64_t, 4>, 255, 19>(), 1000);
+	check(SpecialModulus<uintv_t<uint64_t, 4>, 256, 189>(), 1000);
+	check(MersenneModulus<uintv_t<uint64_t, 2>, 127>(), 1000);
+	check(MersenneModulus<uintv_t<uint32_t, 2>, 61>(), 1000);
+	check(SpecialModulus<uintv_t<uint8_t, 4>, 31, 1>(), 1000);
+	check(SpecialModulus<uintv_t<uint8_t, 3>, 24, 3>(), 1000);
+	check(SpecialModulus<uintv_t<uint64_t, 4>, 200, 75>(), 1000);
+
+	//K more than a limb below the full width takes the bit shifting fold
+	//
+	check(SpecialModulus<uintv_t<uint64_t, 4>, 130, 5>(), 1000);
+	check(SpecialModulus<uintv_t<uint8_t, 4>, 20, 3>(), 1000);
+}
+
+TEST_CASE("MultiModPow", "[scalar_t::MultiModPow]")
+{
+	auto check = [](auto n, size_t k)
+	{
+		using U = decltype(n);
+
+		MontgomeryContext<U> ctx(n);
+
+		std::vector<U> bases(k), exps(k);
+
+		for (size_t i = 0; i < k; i++)
+		{
+			bases[i].Random();
+			exps[i].Random();
+
+			exps[i] >>= i % (limbs<U> * sizeof(n.back()) * 8);
+		}
+
+		U expect(1);
+
+		for (size_t i = 0; i < k; i++)
+			expect = ctx.FromMontgomery(ctx.Multiply(ctx.ToMontgomery(expect), ctx.ToMontgomery(bases[i].ModPow(exps[i], ctx))));
+
+		CHECK(MultiModPow(bases, exps, ctx) == expect % n);
+	};
+
+	for (size_t k : { 0, 1, 2, 5, 17, 79, 80, 300 })
+	{
+		uintv_t<uint64_t, 4> n; n.Random(); n.back() |= 1;
+		check(n, k);
+
+		uintv_t<uint8_t, 6> m; m.Random(); m.back() |= 1;
+		check(m, k);
+	}
+
+	using U = uintv_t<uint64_t, 4>;
+
+	U n; n.Random(); n.back() |= 1;
+	MontgomeryContext<U> ctx(n);
+
+	std::vector<U> bases(100), zeros(100);
+	for (auto& b : bases) b.Random();
+
+	CHECK(MultiModPow(bases, zeros, ctx) == 1);
+}
+
+template < typename C > constexpr bool batch_invertible = requires (C x) { BatchInverse(x); };
+
+TEST_CASE("BatchInverse", "[scalar_t::BatchInverse]")
+{
+	{
+		using U = uintv_t<uint64_t, 4>;
+
+		std::vector<U> v(1000);
+
+		for (auto& e : v)
+			e.Random();
+
+		v[3] = 0;
+		v[500].back() &= ~uint64_t(1);
+
+		auto copy = v;
+		size_t even = std::count_if(v.begin(), v.end(), [](const U& e) { return !(e.back() & 1); });
+
+		CHECK(BatchInverse(v) == even);
+
+		for (size_t i = 0; i < v.size(); i++)
+			CHECK(v[i] == copy[i].MultiplicativeInverse());
+
+		v = copy;
+		CHECK(BatchInverse(std::span<U>(v).subspan(0, 10)) == size_t(std::count_if(v.begin(), v.begin() + 10, [](const U& e) { return !(e.back() & 1); })));
+
+		for (size_t i = 0; i < v.size(); i++)
+			CHECK(v[i] == ((i < 10) ? copy[i].MultiplicativeInverse() : copy[i]));
+
+		static_assert(batch_invertible<std::vector<U>&>);
+		static_assert(!batch_invertible<const std::vector<U>&>);
+		static_assert(!batch_invertible<std::vector<uint64_t>&>);
+		static_assert(!batch_invertible<std::list<U>&>);
+
+		std::array<uintv_t<uint8_t, 3>, 3> small{ uintv_t<uint8_t, 3>(3), uintv_t<uint8_t, 3>(4), uintv_t<uint8_t, 3>(1, 2, 5) };
+		CHECK(BatchInverse(small) == 1);
+		CHECK(small[0] * uintv_t<uint8_t, 3>(3) == uintv_t<uint8_t, 3>(1));
+		CHECK(!small[1]);
+		CHECK(small[2] * uintv_t<uint8_t, 3>(1, 2, 5) == uintv_t<uint8_t, 3>(1));
+	}
+
+	auto modular = [](auto m, size_t n)
+	{
+		using U = decltype(m);
+
+		MontgomeryContext<U> ctx(m);
+
+		std::vector<U> v(n);
+
+		for (auto& e : v)
+			e.Random();
+
+		auto copy = v;
+
+		size_t bad = 0;
+		for (auto& e : copy)
+			if (!e.ModInverse(m))
+				bad++;
+
+		CHECK(BatchInverse(v, ctx) == bad);
+
+		for (size_t i = 0; i < v.size(); i++)
+			CHECK(v[i] == copy[i].ModInverse(m));
+	};
+
+	for (size_t i = 0; i < 10; i++)
+	{
+		uintv_t<uint64_t, 4> m; m.Random(); m.back() |= 1;
+		modular(m, 100);
+	}
+
+	//Composite moduli with small factors so some elements share a factor and force the second pass
+	//
+	modular(uintv_t<uint32_t, 3>(0, 0, 3 * 5 * 7 * 11 * 13), 200);
+	modular(uintv_t<uint8_t, 4>(0, 0, 0, 15), 50);
+
+	{
+		using U = uintv_t<uint64_t, 4>;
+
+		U m; m.Random(); m >>= 1; m.back() |= 1;
+		MontgomeryContext<U> ctx(m);
+
+		std::vector<U> v = { m, U(0), m + m };
+
+		CHECK(BatchInverse(v, ctx) == 3);
+		CHECK(std::all_of(v.begin(), v.end(), [](const U& e) { return !e; }));
+
+		std::vector<U> empty;
+		CHECK(BatchInverse(empty, ctx) == 0);
+	}
+}
+
+TEST_CASE("IsProbablePrime", "[scalar_t::IsProbablePrime]")
+{
+	std::vector<bool> composite(20000);
+
+	composite[0] = composite[1] = true;
+
+	for (size_t i = 2; i < composite.size(); i++)
+		for (size_t j = i * i; !composite[i] && j < composite.size(); j += i)
+			composite[j] = true;
+
+	for (size_t i = 0; i < composite.size(); i++)
+	{
+		CHECK(IsProbablePrime(uintv_t<uint64_t, 2>(0, i)) == !composite[i]);
+		CHECK(IsProbablePrime(uintv_t<uint8_t, 3>(0, uint8_t(i >> 8), uint8_t(i))) == !composite[i]);
+	}
+
+	using U = uintv_t<uint64_t, 4>;
+
+	//Strong pseudoprimes to the leading prime bases and a Carmichael number
+	//
+	CHECK(!IsProbablePrime(U(2047)));
+	CHECK(!IsProbablePrime(U(561)));
+	CHECK(!IsProbablePrime(U(3215031751)));
+	CHECK(!IsProbablePrime(U(3825123056546413051)));
+	CHECK(!IsProbablePrime(U("0 0 0 ffffffffffffffff")));
+	CHECK(IsProbablePrime(U("0 0 0 ffffffffffffffc5")));
+	CHECK(IsProbablePrime(U("0 0 7fffffffffffffff ffffffffffffffff")));
+	CHECK(IsProbablePrime(U("7fffffffffffffff ffffffffffffffff ffffffffffffffff ffffffffffffffed")));
+	CHECK(IsProbablePrime(U("ffffffffffffffff ffffffffffffffff ffffffffffffffff ffffffffffffff43")));
+	CHECK(!IsProbablePrime(U("7fffffffffffffff ffffffffffffffff ffffffffffffffff ffffffffffffffeb")));
+
+	//( 2^61 - 1 ) * ( 2^89 - 1 ) and a square of a large prime
+	//
+	U m61(0x1fffffffffffffff), m89("0 0 1ffffff ffffffffffffffff");
+	CHECK(!IsProbablePrime(m61 * m89));
+	CHECK(!IsProbablePrime(m89 * m89));
+
+	using V = uintv_t<uint32_t, 17>;
+	V m521;
+	for (size_t i = 1; i < 17; i++) m521[i] = 0xffffffff;
+	m521[0] = 0x1ff;
+	CHECK(IsProbablePrime(m521));
+	CHECK(IsProbablePrime(m521, 5));
+	CHECK(!IsProbablePrime(m521 - V(2)));
+
+	//Strong Lucas pseudoprimes pass the Lucas half of BPSW on their own and fail base 2
+	//
+	for (uint64_t n : { 5459, 5777, 10877, 16109, 18971 })
+	{
+		MontgomeryContext<U> ctx{ U(n) };
+
+		CHECK(helper::prime::strong_lucas(ctx));
+		CHECK(!helper::prime::miller_rabin(ctx, U(2)));
+	}
+
+	for (uint64_t n : { 1009, 7919, 104729 })
+		CHECK(helper::prime::strong_lucas(MontgomeryContext<U>(U(n))));
+}
+
+TEST_CASE("RandomPrime", "[scalar_t::RandomPrime]")
+{
+	for (size_t bits : { 2, 3, 8, 17, 21, 64, 100, 256 })
+	{
+		auto p = RandomPrime<uintv_t<uint64_t, 4>>(bits);
+
+		CHECK(p.Bits() + 1 == bits);
+		CHECK(IsProbablePrime(p));
+	}
+
+	for (size_t bits : { 24, 40 })
+	{
+		auto p = RandomPrime<uintv_t<uint8_t, 5>>(bits, 3);
+
+		CHECK(p.Bits() + 1 == bits);
+		CHECK(IsProbablePrime(p));
+	}
+
+	//bits == width, the windows past the top wrap around modulo 2^width
+	//
+	for (size_t i = 0; i < 20; i++)
+	{
+		auto p = RandomPrime<uintv_t<uint8_t, 3>>(24, 8);
+
+		CHECK(p.Bits() + 1 == 24);
+		CHECK(IsProbablePrime(p));
+	}
+
+	auto p = RandomPrime<uintv_t<uint64_t, 8>>(512, 4);
+
+	CHECK(p.Bits() + 1 == 512);
+	CHECK(IsProbablePrime(p, 4));
+}
+
+TEST_CASE("ISqrt and IRoot", "[scalar_t::uintv_t::IRoot]")
+{
+	auto check = [](auto n, size_t k)
+	{
+		using U = decltype(n);
+		using T = typename U::value_type;
+		constexpr size_t s = limbs<U>;
+		using W = uintv_t<T, 2 * s + 2>;
+
+		U r = (k == 2) ? n.ISqrt() : n.IRoot(k);
+
+		//r^k <= n < ( r + 1 )^k, powers formed wide enough not to wrap
+		//
+		auto power = [&](const U& x)
+		{
+			W w, p(1);
+			std::copy(x.begin(), x.end(), w.end() - s);
+
+			for (size_t i = 0; i < k && !(p[0] | p[1]); i++)
+				p = p * w;
+
+			return p;
+		};
+
+		W wn;
+		std::copy(n.begin(), n.end(), wn.end() - s);
+
+		CHECK(!finite_vector_greater(power(r), wn));
+		CHECK(finite_vector_greater(power(r + U(1)), wn));
+	};
+
+	for (size_t i = 0; i < 300; i++)
+	{
+		uintv_t<uint64_t, 4> n; n.Random();
+		n >>= i % 256;
+
+		if (!n)
+			continue;
+
+		check(n, 2);
+		check(n, 2 + i % 7);
+
+		uintv_t<uint8_t, 3> m; m.Random();
+		m >>= i % 24;
+
+		if (m)
+		{
+			check(m, 2);
+			check(m, 3 + i % 4);
+		}
+
+		uintv_t<uint32_t, 33> w; w.Random();
+		w >>= i % 1000;
+
+		if (w)
+			check(w, 2);
+	}
+
+	using U = uintv_t<uint64_t, 4>;
+
+	U big; big.BinaryInvert();
+
+	check(big, 2);
+	check(big, 3);
+	check(big, 255);
+	check(big, 256);
+
+	//k >= 256 takes two 8 bit limbs, the reciprocal of k comes from a two limb division
+	//
+	uintv_t<uint8_t, 64> wide; wide.BinaryInvert();
+
+	for (size_t k : { 256, 257, 300, 511 })
+	{
+		check(wide, k);
+
+		uintv_t<uint8_t, 64> r; r.Random();
+		r[0] |= 0x80;
+		check(r, k);
+	}
+
+	CHECK(U(0).ISqrt() == 0);
+	CHECK(U(1).ISqrt() == 1);
+	CHECK(U(15).ISqrt() == 3);
+	CHECK(U(16).ISqrt() == 4);
+	CHECK(U(1000000).IRoot(3) == 100);
+	CHECK(U(999999).IRoot(3) == 99);
+
+	CHECK(U(0).IRoot(1) == 0);
+	CHECK(U(7).IRoot(1) == 7);
+	CHECK(big.IRoot(1) == big);
+
+	CHECK(U(12345).IRoot(0) == 0);
+	CHECK(U(0).IRoot(0) == 0);
+	CHECK(big.IRoot(0) == 0);
+
+	U sq; sq.Random(); sq >>= 128;
+	CHECK((sq * sq).ISqrt() == sq);
+	CHECK((sq * sq - U(1)).ISqrt() == sq - U(1));
+}
+
+TEST_CASE("rns_t", "[scalar_t::rns_t]")
+{
+	//2^62 - 57, 2^62 - 87, 2^62 - 117, 2^62 - 143, 2^62 - 153
+	//
+	constexpr uint64_t p0 = 4611686018427387847ull, p1 = 4611686018427387817ull, p2 = 4611686018427387787ull,
+		p3 = 4611686018427387761ull, p4 = 4611686018427387751ull;
+
+	for (auto q : { p0, p1, p2, p3, p4 })
+		CHECK(IsProbablePrime(uintv_t<uint64_t, 1>(q)));
+
+	{
+		using U = uintv_t<uint64_t, 2>;
+		using R = rns_t<U, p0, p1, p2, p3, p4>;
+
+		auto m = R::Modulus();
+		CHECK(m.Bits() == 309);
+
+		for (size_t i = 0; i < 200; i++)
+		{
+			U a, b, c, d;
+			a.Random(); b.Random(); c.Random(); d.Random();
+
+			CHECK(R(a).Value() == a);
+			CHECK(R(a).Residue(2) == (uintv_t<uint64_t, 2>(a) % uintv_t<uint64_t, 2>(p2)).back());
+
+			CHECK((R(a) * R(b)).Value() == a * b);
+			CHECK((R(a) * R(b) + R(c) * R(d)).Value() == a * b + c * d);
+
+			if (!finite_vector_greater(b, a))
+				CHECK((R(a) - R(b)).Value() == a - b);
+			else
+				CHECK((R(b) - R(a)).Value() == b - a);
+
+			R x(a);
+			x *= R(b);
+			x -= R(a) * R(b);
+
+			CHECK(x == R());
+		}
+	}
+
+	{
+		using U = uintv_t<uint8_t, 3>;
+		using R = rns_t<U, p0>;
+
+		for (size_t i = 0; i < 200; i++)
+		{
+			U a, b;
+			a.Random(); b.Random();
+
+			CHECK((R(a) * R(b)).Value() == a * b);
+			CHECK((R(a) + R(b)).Value() == a + b);
+		}
+	}
+}
+
+TEST_CASE("uintv_batch", "[scalar_t::uintv_batch]")
+{
+	auto check = [](auto tag)
+	{
+		using U = decltype(tag);
+		using T = typename U::value_type;
+		constexpr size_t S = limbs<U>, N = 19;
+
+		std::array<U, N> a, b, out;
+
+		for (size_t j = 0; j < N; j++)
+		{
+			a[j].Random();
+			b[j].Random();
+		}
+
+		//equal integers, equal high limbs and carries through every limb
+		//
+		b[1] = a[1];
+		b[2] = a[2]; b[2].back() ^= 1;
+		a[3] = U(0); a[3].BinaryInvert(); b[3] = U(1);
+		a[4] = U(0); b[4] = U(1);
+
+		uintv_batch<T, S, N> x(a.data()), y(b.data());
+
+		x.Store(out.data());
+		CHECK(out == a);
+
+		for (size_t j = 0; j < N; j++)
+			CHECK(y[j] == b[j]);
+
+		auto s = x + y, d = x - y, e = x ^ y, p = x * y;
+		auto less = x.Less(y), equal = x.Equal(y);
+
+		for (size_t j = 0; j < N; j++)
+		{
+			CHECK(s[j] == a[j] + b[j]);
+			CHECK(d[j] == a[j] - b[j]);
+			CHECK(e[j] == (a[j] ^ b[j]));
+			CHECK(p[j] == a[j] * b[j]);
+			CHECK(less[j] == finite_vector_greater(b[j], a[j]));
+			CHECK(equal[j] == (a[j] == b[j]));
+		}
+
+		x += y;
+		x -= y;
+		x ^= y;
+		x ^= y;
+
+		auto z = x;
+		z *= y;
+		CHECK(z == p);
+
+		CHECK(x == uintv_batch<T, S, N>(a.data()));
+	};
+
+	for (size_t i = 0; i < 20; i++)
+	{
+		check(uintv_t<uint64_t, 4>());
+		check(uintv_t<uint64_t, 3>());
+		check(uintv_t<uint32_t, 5>());
+		check(uintv_t<uint16_t, 4>());
+		check(uintv_t<uint8_t, 6>());
+		check(uintv_t<uint32_t, 1>());
+
+		//whole transpose blocks with leftover limb rows
+		//
+		check(uintv_t<uint64_t, 6>());
+		check(uintv_t<uint32_t, 8>());
+		check(uintv_t<uint32_t, 11>());
+	}
+
+	//26 bit digits
+	//
+	check(uintv_t<uint64_t, 128>());
+}
+
+TEST_CASE("ADX kernels", "[scalar_t::adx]")
+{
+#if defined(SCALAR_T_ADX)
+	if (!intrinsic::bmi2_adx)
+		return;
+
+	//The same values in 32 bit limbs never reach the dispatch and serve as the reference
+	//
+	auto check = [](auto tag)
+	{
+		using U = decltype(tag);
+		constexpr size_t S = limbs<U>;
+		using HW = uintv_t<uint32_t, 4 * S>;
+
+		auto half = [](const auto& v)
+		{
+			uintv_t<uint32_t, 2 * limbs<std::remove_cvref_t<decltype(v)>>> h;
+
+			for (size_t i = 0; i < v.size(); i++)
+			{
+				h[2 * i] = uint32_t(v[i] >> 32);
+				h[2 * i + 1] = uint32_t(v[i]);
+			}
+
+			return h;
+		};
+
+		U a, b, c; a.Random(); b.Random(); c.Random();
+
+		uintv_t<uint64_t, 2 * S> w;
+		helper::adx::mul_basecase(a.data(), b.data(), S, w.data());
+
+		auto a32 = half(a), b32 = half(b), c32 = half(c);
+
+		HW ha, hb;
+		std::copy(a32.begin(), a32.end(), ha.end() - 2 * S);
+		std::copy(b32.begin(), b32.end(), hb.end() - 2 * S);
+
+		CHECK(half(w) == ha * hb);
+
+		U l;
+		helper::adx::mullo_basecase(a.data(), b.data(), S, l.data());
+		CHECK(half(l) == a32 * b32);
+
+		U f = c;
+		helper::adx::addmullo(a.data(), b.data(), S, f.data());
+		CHECK(half(f) == c32 + a32 * b32);
+
+		U r = c;
+		uint64_t top = helper::adx::addmul_1(r.data(), a.data(), S, b.back());
+
+		uintv_t<uint32_t, 2 * S + 2> wr, wa, wb;
+		std::copy(c32.begin(), c32.end(), wr.begin() + 2);
+		std::copy(a32.begin(), a32.end(), wa.begin() + 2);
+		wb[2 * S + 1] = uint32_t(b.back()); wb[2 * S] = uint32_t(b.back() >> 32);
+
+		auto e = wr + wa * wb;
+		CHECK(e[0] == uint32_t(top >> 32));
+		CHECK(e[1] == uint32_t(top));
+		auto r32 = half(r);
+		CHECK(std::equal(e.begin() + 2, e.end(), r32.begin()));
+
+		//carries through every limb
+		//
+		U m; m.BinaryInvert();
+		helper::adx::mul_basecase(m.data(), m.data(), S, w.data());
+		auto m32 = half(m);
+		std::copy(m32.begin(), m32.end(), ha.end() - 2 * S);
+		CHECK(half(w) == ha * ha);
+	};
+
+	for (size_t i = 0; i < 100; i++)
+	{
+		check(uintv_t<uint64_t, 1>());
+		check(uintv_t<uint64_t, 2>());
+		check(uintv_t<uint64_t, 3>());
+		check(uintv_t<uint64_t, 8>());
+		check(uintv_t<uint64_t, 17>());
+	}
+
+	//Montgomery rows against the portable CIOS on the 32 bit limb image
+	//
+	using U = uintv_t<uint64_t, 8>;
+	using H = uintv_t<uint32_t, 16>;
+
+	for (size_t i = 0; i < 100; i++)
+	{
+		U m, a, b; m.Random(); a.Random(); b.Random();
+		m.back() |= 1;
+		a = a % m; b = b % m;
+
+		MontgomeryContext<U> ctx{ m };
+		H hm, ha, hb;
+
+		for (size_t j = 0; j < 8; j++)
+		{
+			hm[2 * j] = uint32_t(m[j] >> 32); hm[2 * j + 1] = uint32_t(m[j]);
+			ha[2 * j] = uint32_t(a[j] >> 32); ha[2 * j + 1] = uint32_t(a[j]);
+			hb[2 * j] = uint32_t(b[j] >> 32); hb[2 * j + 1] = uint32_t(b[j]);
+		}
+
+		MontgomeryContext<H> hctx{ hm };
+
+		U p = ctx.FromMontgomery(ctx.Multiply(ctx.ToMontgomery(a), ctx.ToMontgomery(b)));
+		H hp = hctx.FromMontgomery(hctx.Multiply(hctx.ToMontgomery(ha), hctx.ToMontgomery(hb)));
+
+		for (size_t j = 0; j < 8; j++)
+			CHECK(p[j] == ((uint64_t(hp[2 * j]) << 32) | hp[2 * j + 1]));
+	}
+#endif
+}